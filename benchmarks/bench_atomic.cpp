@@ -0,0 +1,102 @@
+#include "catch.hpp"
+
+#include "expected_atomic.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__cpp_lib_atomic_wait) && defined(__SIZEOF_INT128__)
+
+namespace {
+
+enum class Error : std::uint8_t {
+    Pending,
+};
+
+struct Pair {
+    std::uint32_t first;
+    std::uint32_t second;
+};
+
+constexpr int kOperations = 1 << 12;
+
+/// Slot guarded by a mutex, what [atomic_expected] replaces
+template <typename ValueType>
+class LockedSlot {
+  public:
+    pstd::expected<ValueType, Error> load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return result_;
+    }
+
+    void store(const pstd::expected<ValueType, Error> &result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result_ = result;
+    }
+
+  private:
+    mutable std::mutex mutex_;
+    pstd::expected<ValueType, Error> result_;
+};
+
+/// One writer and [readers] readers each doing [kOperations] operations on [slot]
+template <typename Slot, typename ValueType>
+long contend(Slot &slot, const int readers, ValueType (*make)(int)) {
+    std::vector<long> counts(readers);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            for (int i = 0; i < kOperations; i++) {
+                counts[r] += slot.load().has_value();
+            }
+        });
+    }
+    for (int i = 0; i < kOperations; i++) {
+        slot.store(make(i));
+    }
+    long sum = 0;
+    for (int r = 0; r < readers; r++) {
+        threads[r].join();
+        sum += counts[r];
+    }
+    return sum;
+}
+
+std::uint32_t make_word(const int i) {
+    return static_cast<std::uint32_t>(i);
+}
+
+Pair make_pair(const int i) {
+    return Pair{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i)};
+}
+
+TEST_CASE("AtomicContention", "benchmark") {
+    for (const int readers : {1, 4, 16, 64}) {
+        const auto suffix = ", " + std::to_string(readers) + " readers";
+        long sum = 0;
+
+        BENCHMARK("atomic_expected 8 bytes" + suffix) {
+            pstd::atomic_expected<std::uint32_t, Error> slot;
+            sum += contend(slot, readers, make_word);
+        }
+        BENCHMARK("mutex 8 bytes" + suffix) {
+            LockedSlot<std::uint32_t> slot;
+            sum += contend(slot, readers, make_word);
+        }
+        BENCHMARK("atomic_expected 16 bytes" + suffix) {
+            pstd::atomic_expected<Pair, Error> slot;
+            sum += contend(slot, readers, make_pair);
+        }
+        BENCHMARK("mutex 16 bytes" + suffix) {
+            LockedSlot<Pair> slot;
+            sum += contend(slot, readers, make_pair);
+        }
+        REQUIRE(sum >= 0);
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,75 @@
+#include "catch.hpp"
+
+#include "expected.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Error : int {
+    Bad,
+    VeryBad,
+    Terrible,
+};
+
+using Expected = pstd::expected<int, Error>;
+
+constexpr std::size_t kCount = 1 << 16;
+
+/// The chain of branches that [operator<] used before [operator<=>]
+bool branchy_less(const Expected &a, const Expected &b) {
+    const bool a_has_value = a.has_value();
+    const bool b_has_value = b.has_value();
+    if (a_has_value && b_has_value) {
+        return (*a < *b);
+    } else if (a_has_value && !b_has_value) {
+        return true;
+    } else if (!a_has_value && b_has_value) {
+        return false;
+    } else {
+        return (a.error() < b.error());
+    }
+}
+
+std::vector<Expected> make_results(const double error_rate) {
+    std::mt19937 generator(0xC0FFEE);
+    std::bernoulli_distribution is_error(error_rate);
+    std::uniform_int_distribution<int> value(-1'000'000, 1'000'000);
+    std::uniform_int_distribution<int> error(0, 2);
+
+    std::vector<Expected> results;
+    results.reserve(kCount);
+    for (std::size_t i = 0; i < kCount; i++) {
+        if (is_error(generator)) {
+            results.emplace_back(static_cast<Error>(error(generator)));
+        } else {
+            results.emplace_back(value(generator));
+        }
+    }
+    return results;
+}
+
+TEST_CASE("SortResults", "benchmark") {
+    for (const int error_percent : {1, 50}) {
+        const auto results = make_results(error_percent / 100.0);
+        const auto rate = std::to_string(error_percent) + "% errors";
+
+        BENCHMARK("sort, branchy operator<, " + rate) {
+            auto copy = results;
+            std::sort(copy.begin(), copy.end(), branchy_less);
+        }
+        BENCHMARK("sort, operator<=>, " + rate) {
+            auto copy = results;
+            std::sort(copy.begin(), copy.end());
+        }
+        BENCHMARK("sort + unique, operator<=>, " + rate) {
+            auto copy = results;
+            std::sort(copy.begin(), copy.end());
+            copy.erase(std::unique(copy.begin(), copy.end()), copy.end());
+        }
+    }
+}
+
+} // namespace
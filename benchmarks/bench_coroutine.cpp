@@ -0,0 +1,113 @@
+#include "catch.hpp"
+
+#include "expected_coroutine.h"
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+
+enum class Error {
+    Negative,
+    Overflow,
+};
+
+using Expected = pstd::expected<int, Error>;
+
+constexpr std::size_t kCount = 1 << 16;
+
+[[gnu::noinline]] Expected check(const int value) {
+    if (value < 0) {
+        return Error::Negative;
+    }
+    if (value > 1'000'000) {
+        return Error::Overflow;
+    }
+    return value;
+}
+
+[[gnu::noinline]] int check_or_throw(const int value) {
+    if (value < 0) {
+        throw std::domain_error("negative");
+    }
+    if (value > 1'000'000) {
+        throw std::overflow_error("overflow");
+    }
+    return value;
+}
+
+Expected with_try(const int a, const int b, const int c) {
+    PSTD_TRY(x, check(a));
+    PSTD_TRY(y, check(b));
+    PSTD_TRY(z, check(c));
+    return x + y + z;
+}
+
+Expected with_coroutine(const int a, const int b, const int c) {
+    const int x = co_await check(a);
+    const int y = co_await check(b);
+    const int z = co_await check(c);
+    co_return x + y + z;
+}
+
+int with_exceptions(const int a, const int b, const int c) {
+    return check_or_throw(a) + check_or_throw(b) + check_or_throw(c);
+}
+
+std::vector<int> make_inputs(const int error_percent) {
+    std::mt19937 generator(0xC0FFEE);
+    std::bernoulli_distribution is_error(error_percent / 100.0);
+    std::uniform_int_distribution<int> value(0, 1'000'000);
+    std::vector<int> inputs(kCount);
+    for (auto &input : inputs) {
+        input = (is_error(generator)) ? (-1) : (value(generator));
+    }
+    return inputs;
+}
+
+template <typename F>
+long run(const std::vector<int> &inputs, F &&f) {
+    long sum = 0;
+    for (std::size_t i = 0; i + 2 < inputs.size(); i++) {
+        const Expected result = f(inputs[i], inputs[i + 1], inputs[i + 2]);
+        sum += (result.has_value()) ? (*result) : (-1);
+    }
+    return sum;
+}
+
+TEST_CASE("CoroutinePropagation", "benchmark") {
+    for (const int error_percent : {0, 1, 10}) {
+        const auto inputs = make_inputs(error_percent);
+        const auto rate = ", " + std::to_string(error_percent) + "% errors";
+
+        long try_sum = 0;
+        long coroutine_sum = 0;
+        long exception_sum = 0;
+        BENCHMARK("PSTD_TRY" + rate) {
+            try_sum = run(inputs, with_try);
+        }
+        BENCHMARK("co_await" + rate) {
+            coroutine_sum = run(inputs, with_coroutine);
+        }
+        BENCHMARK("exceptions" + rate) {
+            exception_sum = run(inputs, [](const int a, const int b, const int c) -> Expected {
+                try {
+                    return with_exceptions(a, b, c);
+                } catch (const std::domain_error &) {
+                    return Error::Negative;
+                } catch (const std::overflow_error &) {
+                    return Error::Overflow;
+                }
+            });
+        }
+        REQUIRE(coroutine_sum == try_sum);
+        REQUIRE(exception_sum == try_sum);
+    }
+}
+
+} // namespace
+
+#endif
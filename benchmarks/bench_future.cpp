@@ -0,0 +1,112 @@
+#include "catch.hpp"
+
+#include "expected_future.h"
+
+#include <future>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#if defined(__cpp_lib_atomic_wait)
+
+namespace {
+
+enum class Error {
+    Broken,
+};
+
+constexpr int kRoundTrips = 1 << 12;
+
+/// A worker thread answers each request with the next integer, the caller waits for every reply
+template <typename Promise, typename Future, typename MakePromise>
+long round_trips(MakePromise &&make_promise) {
+    std::vector<Promise> requests;
+    std::vector<Promise> replies;
+    std::vector<Future> request_futures;
+    std::vector<Future> reply_futures;
+    for (int i = 0; i < kRoundTrips; i++) {
+        requests.push_back(make_promise());
+        replies.push_back(make_promise());
+        request_futures.push_back(requests.back().get_future());
+        reply_futures.push_back(replies.back().get_future());
+    }
+
+    std::thread worker([&] {
+        for (int i = 0; i < kRoundTrips; i++) {
+            replies[i].set_value(*request_futures[i].get() + 1);
+        }
+    });
+    long sum = 0;
+    for (int i = 0; i < kRoundTrips; i++) {
+        requests[i].set_value(i);
+        sum += *reply_futures[i].get();
+    }
+    worker.join();
+    return sum;
+}
+
+/// [std::future] of [expected] so the comparison is only about the channel
+using StdPromise = std::promise<pstd::expected<int, Error>>;
+using StdFuture = std::future<pstd::expected<int, Error>>;
+
+using Promise = pstd::promise<int, Error>;
+using Future = pstd::future<int, Error>;
+
+TEST_CASE("FutureRoundTrip", "benchmark") {
+    long std_sum = 0;
+    long pstd_sum = 0;
+    long pooled_sum = 0;
+    std::pmr::synchronized_pool_resource pool;
+
+    BENCHMARK("std::promise") {
+        std_sum = round_trips<StdPromise, StdFuture>([] { return StdPromise(); });
+    }
+    BENCHMARK("pstd::promise") {
+        pstd_sum = round_trips<Promise, Future>([] { return Promise(); });
+    }
+    BENCHMARK("pstd::promise, pool") {
+        pooled_sum = round_trips<Promise, Future>([&pool] {
+            return Promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(&pool));
+        });
+    }
+    REQUIRE(pstd_sum == std_sum);
+    REQUIRE(pooled_sum == std_sum);
+}
+
+TEST_CASE("FutureCreate", "benchmark") {
+    long std_sum = 0;
+    long pstd_sum = 0;
+    long pooled_sum = 0;
+    std::pmr::unsynchronized_pool_resource pool;
+
+    BENCHMARK("std::promise") {
+        for (int i = 0; i < kRoundTrips; i++) {
+            StdPromise promise;
+            StdFuture future = promise.get_future();
+            promise.set_value(i);
+            std_sum += *future.get();
+        }
+    }
+    BENCHMARK("pstd::promise") {
+        for (int i = 0; i < kRoundTrips; i++) {
+            Promise promise;
+            Future future = promise.get_future();
+            promise.set_value(i);
+            pstd_sum += *future.get();
+        }
+    }
+    BENCHMARK("pstd::promise, pool") {
+        for (int i = 0; i < kRoundTrips; i++) {
+            Promise promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(&pool));
+            Future future = promise.get_future();
+            promise.set_value(i);
+            pooled_sum += *future.get();
+        }
+    }
+    REQUIRE(pstd_sum == std_sum);
+    REQUIRE(pooled_sum == std_sum);
+}
+
+} // namespace
+
+#endif
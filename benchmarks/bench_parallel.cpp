@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include "expected_parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    Diverged,
+};
+
+constexpr int kCount = 1 << 14;
+
+/// Enough work per element for the scheduling cost not to dominate
+pstd::expected<double, Error> simulate(const int seed) {
+    double x = seed;
+    for (int i = 0; i < 200; i++) {
+        x = std::sqrt(x * x + 1.0);
+    }
+    if (!std::isfinite(x)) {
+        return Error::Diverged;
+    }
+    return x;
+}
+
+TEST_CASE("ParallelTransformScaling", "benchmark") {
+    std::vector<int> seeds(kCount);
+    std::iota(seeds.begin(), seeds.end(), 0);
+
+    double sequential = 0;
+    BENCHMARK("sequential") {
+        double total = 0;
+        for (const int seed : seeds) {
+            total += *simulate(seed);
+        }
+        // The body runs as many times as the benchmark needs, so only the last run is kept
+        sequential = total;
+    }
+
+    const std::size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= 2 * hardware; threads *= 2) {
+        pstd::thread_pool pool(threads);
+        double sum = 0;
+        BENCHMARK("parallel_transform, " + std::to_string(threads) + " threads") {
+            const auto result = pstd::parallel_transform(pool, seeds, simulate);
+            sum = std::accumulate(result->begin(), result->end(), 0.0);
+        }
+        REQUIRE(sum == sequential);
+    }
+}
+
+TEST_CASE("PartitionResultsScaling", "benchmark") {
+    constexpr std::size_t kResults = 1 << 22;
+    std::vector<pstd::expected<double, Error>> results;
+    results.reserve(kResults);
+    for (std::size_t i = 0; i < kResults; i++) {
+        results.push_back((i % 16 == 0) ? (pstd::expected<double, Error>(Error::Diverged)) :
+                                          (pstd::expected<double, Error>(static_cast<double>(i))));
+    }
+
+    std::size_t sequential = 0;
+    BENCHMARK("stable_partition") {
+        auto copy = results;
+        const auto middle = std::stable_partition(copy.begin(), copy.end(),
+                                                  [](const auto &result) { return result.has_value(); });
+        sequential = static_cast<std::size_t>(middle - copy.begin());
+    }
+
+    const std::size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= 2 * hardware; threads *= 2) {
+        pstd::thread_pool pool(threads);
+        std::size_t values = 0;
+        BENCHMARK("partition_results, " + std::to_string(threads) + " threads") {
+            auto copy = results;
+            values = pstd::partition_results(pool, std::move(copy)).values.size();
+        }
+        REQUIRE(values == sequential);
+    }
+}
+
+} // namespace
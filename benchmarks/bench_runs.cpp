@@ -0,0 +1,55 @@
+#include "catch.hpp"
+
+#include "expected_runs.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    None,
+    Invalid,
+};
+
+constexpr std::size_t kCount = 1 << 22;
+
+TEST_CASE("StateRunsErrors", "benchmark") {
+    for (const double density : {1e-6, 1e-4, 1e-2, 0.1, 0.5}) {
+        std::mt19937 generator(0xC0FFEE);
+        std::bernoulli_distribution is_error(density);
+        pstd::expected_vector<int, Error> results;
+        results.reserve(kCount);
+        for (std::size_t i = 0; i < kCount; i++) {
+            if (is_error(generator)) {
+                results.push_back(pstd::make_unexpected<Error>(Error::Invalid));
+            } else {
+                results.push_back(static_cast<int>(i));
+            }
+        }
+        const pstd::state_runs runs = pstd::state_runs::from_vector(results);
+        const auto rate = ", " + std::to_string(density) + " errors";
+
+        std::size_t bitmap_sum = 0;
+        std::size_t runs_sum = 0;
+        std::size_t run_count = 0;
+        BENCHMARK("bitmap for_each_error" + rate) {
+            std::size_t sum = 0;
+            results.for_each_error([&](const std::size_t index, Error) { sum += index; });
+            bitmap_sum = sum;
+        }
+        BENCHMARK("state_runs for_each_error" + rate) {
+            std::size_t sum = 0;
+            runs.for_each_error([&](const std::size_t index) { sum += index; });
+            runs_sum = sum;
+        }
+        BENCHMARK("state_runs from_bitmap" + rate) {
+            run_count = pstd::state_runs::from_vector(results).runs().size();
+        }
+        REQUIRE(runs_sum == bitmap_sum);
+        REQUIRE(run_count == runs.runs().size());
+    }
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+#include "catch.hpp"
+
+#include "expected_scan.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__cpp_lib_span)
+
+namespace {
+
+enum class Error {
+    Invalid = 1,
+};
+
+constexpr std::size_t kCount = 1 << 20;
+
+template <typename V>
+void run(const std::string &type) {
+    using Expected = pstd::expected<V, Error>;
+    for (const int error_percent : {1, 50}) {
+        std::mt19937 generator(0xC0FFEE);
+        std::bernoulli_distribution is_error(error_percent / 100.0);
+        std::vector<Expected> results;
+        results.reserve(kCount);
+        for (std::size_t i = 0; i < kCount; i++) {
+            results.push_back((is_error(generator)) ? (Expected(pstd::make_unexpected<Error>(Error::Invalid))) :
+                                                      (Expected(static_cast<V>(i))));
+        }
+        const std::span<const Expected> span(results);
+        std::vector<V> out(kCount);
+        const auto suffix = ", " + type + ", " + std::to_string(error_percent) + "% errors";
+        const auto has_error = [](const Expected &result) { return !result.has_value(); };
+
+        std::size_t reference = 0;
+        std::size_t scanned = 0;
+        BENCHMARK("std::count_if" + suffix) {
+            reference += static_cast<std::size_t>(std::count_if(results.begin(), results.end(), has_error));
+        }
+        for (const auto set : {pstd::scan::instruction_set::scalar, pstd::scan::instruction_set::sse42,
+                               pstd::scan::instruction_set::avx2}) {
+            if (!pstd::scan::is_supported(set)) {
+                continue;
+            }
+            const std::string name = (set == pstd::scan::instruction_set::avx2)  ? ("avx2") :
+                                     (set == pstd::scan::instruction_set::sse42) ? ("sse4.2") : ("scalar");
+            BENCHMARK("count_errors " + name + suffix) {
+                scanned += pstd::scan::count_errors(span, set);
+            }
+        }
+
+        std::size_t copied = 0;
+        BENCHMARK("std::copy_if" + suffix) {
+            auto end = out.begin();
+            for (const Expected &result : results) {
+                if (result) {
+                    *end++ = *result;
+                }
+            }
+            copied += static_cast<std::size_t>(end - out.begin());
+        }
+        BENCHMARK("gather_values" + suffix) {
+            copied -= pstd::scan::gather_values(span, std::span<V>(out));
+        }
+
+        REQUIRE(scanned % reference == 0);
+        REQUIRE(copied == 0);
+    }
+}
+
+TEST_CASE("ScanKernels", "benchmark") {
+    run<int>("int");
+    run<double>("double");
+}
+
+} // namespace
+
+#endif
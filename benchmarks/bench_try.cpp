@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include "expected.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    Negative,
+    Overflow,
+};
+
+using Expected = pstd::expected<int, Error>;
+
+constexpr std::size_t kCount = 1 << 16;
+
+[[gnu::noinline]] Expected check(const int value) {
+    if (value < 0) {
+        return Error::Negative;
+    }
+    if (value > 1'000'000) {
+        return Error::Overflow;
+    }
+    return value;
+}
+
+Expected hand_written(const int a, const int b, const int c) {
+    auto x = check(a);
+    if (!x) {
+        return pstd::make_unexpected<Error>(x.error());
+    }
+    auto y = check(b);
+    if (!y) {
+        return pstd::make_unexpected<Error>(y.error());
+    }
+    auto z = check(c);
+    if (!z) {
+        return pstd::make_unexpected<Error>(z.error());
+    }
+    return *x + *y + *z;
+}
+
+Expected with_try(const int a, const int b, const int c) {
+    PSTD_TRY(x, check(a));
+    PSTD_TRY(y, check(b));
+    PSTD_TRY(z, check(c));
+    return x + y + z;
+}
+
+Expected with_try_expr(const int a, const int b, const int c) {
+    return PSTD_TRY_EXPR(check(a)) + PSTD_TRY_EXPR(check(b)) + PSTD_TRY_EXPR(check(c));
+}
+
+template <typename F>
+long run(const std::vector<int> &inputs, F &&f) {
+    long sum = 0;
+    for (std::size_t i = 0; i + 2 < inputs.size(); i++) {
+        const auto result = f(inputs[i], inputs[i + 1], inputs[i + 2]);
+        sum += (result.has_value()) ? (*result) : (-1);
+    }
+    return sum;
+}
+
+TEST_CASE("Propagation", "benchmark") {
+    std::mt19937 generator(0xC0FFEE);
+    std::uniform_int_distribution<int> distribution(-50'000, 1'000'000);
+    std::vector<int> inputs(kCount);
+    for (auto &input : inputs) {
+        input = distribution(generator);
+    }
+
+    long hand_written_sum = 0;
+    long try_sum = 0;
+    long try_expr_sum = 0;
+    BENCHMARK("hand written early return") {
+        hand_written_sum = run(inputs, hand_written);
+    }
+    BENCHMARK("PSTD_TRY") {
+        try_sum = run(inputs, with_try);
+    }
+    BENCHMARK("PSTD_TRY_EXPR") {
+        try_expr_sum = run(inputs, with_try_expr);
+    }
+    REQUIRE(try_sum == hand_written_sum);
+    REQUIRE(try_expr_sum == hand_written_sum);
+}
+
+} // namespace
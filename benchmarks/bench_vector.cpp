@@ -0,0 +1,52 @@
+#include "catch.hpp"
+
+#include "expected_vector.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    None,
+    Invalid,
+};
+
+using Expected = pstd::expected<double, Error>;
+
+constexpr std::size_t kCount = 1 << 20;
+
+TEST_CASE("ExpectedVectorSum", "benchmark") {
+    for (const int error_percent : {0, 10, 50}) {
+        std::mt19937 generator(0xC0FFEE);
+        std::bernoulli_distribution is_error(error_percent / 100.0);
+        std::vector<Expected> array;
+        pstd::expected_vector<double, Error> soa;
+        array.reserve(kCount);
+        soa.reserve(kCount);
+        for (std::size_t i = 0; i < kCount; i++) {
+            const Expected result = (is_error(generator)) ? (Expected(Error::Invalid)) :
+                                                            (Expected(static_cast<double>(i % 1000)));
+            array.push_back(result);
+            soa.push_back(result);
+        }
+        const auto rate = ", " + std::to_string(error_percent) + "% errors";
+
+        double array_sum = 0;
+        double soa_sum = 0;
+        BENCHMARK("std::vector<expected>" + rate) {
+            for (const Expected &result : array) {
+                if (result.has_value()) {
+                    array_sum += *result;
+                }
+            }
+        }
+        BENCHMARK("expected_vector" + rate) {
+            soa.for_each_value([&](std::size_t, const double value) { soa_sum += value; });
+        }
+        REQUIRE(soa_sum == array_sum);
+    }
+}
+
+} // namespace
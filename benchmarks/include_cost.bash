@@ -0,0 +1,32 @@
+#!/bin/bash
+# Measures the front end cost of including each public header, by timing -fsyntax-only over a
+# translation unit that only includes it and declares a function returning an [expected]
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+REPETITIONS=${REPETITIONS:-20}
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+measure() {
+    local header=$1
+    printf '#include "%s"\nstruct Data;\nenum class Error;\npstd::expected<Data, Error> parse(const char *);\n' \
+        "${header}" > "${WORK}/tu.cpp"
+
+    local start=$(date +%s%N)
+    for _ in $(seq "${REPETITIONS}"); do
+        ${CXX} -std=c++20 -fsyntax-only -I"${ROOT}/expected/include" "${WORK}/tu.cpp"
+    done
+    local end=$(date +%s%N)
+
+    local lines=$(${CXX} -std=c++20 -E -I"${ROOT}/expected/include" "${WORK}/tu.cpp" | wc -l)
+    printf '%-28s %8d ms %10d preprocessed lines\n' "${header}" \
+        $(( (end - start) / 1000000 / REPETITIONS )) "${lines}"
+}
+
+measure expected_fwd.h
+measure expected.h
@@ -0,0 +1,61 @@
+#!/bin/bash
+# Measures what expected_instantiations saves, by building [UNITS] translation units which each use
+# the std::string, int and std::size_t specializations, once including expected.h and once including
+# expected_instantiations.h plus compiling the library itself, at -O0 and at -O2
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+UNITS=${UNITS:-24}
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+for unit in $(seq "${UNITS}"); do
+    cat > "${WORK}/unit${unit}.cpp" << SOURCE
+#include HEADER
+
+#include <string>
+#include <system_error>
+
+using Text = pstd::expected<std::string, std::error_code>;
+using Number = pstd::expected<int, std::error_code>;
+using Size = pstd::expected<std::size_t, std::error_code>;
+
+std::size_t unit${unit}(Text text, Number number, Size size) {
+    Text copy = text;
+    copy = std::make_error_code(std::errc::invalid_argument);
+    number = static_cast<int>(text.value_or("").size());
+    size = text.has_value() ? Size(text->size()) : Size(text.error());
+    return copy.error_or(std::error_code{}).value() + number.value() + size.value_or(0);
+}
+SOURCE
+done
+
+measure() {
+    local level=$1
+    local header=$2
+    local library=$3
+    rm -f "${WORK}"/*.o
+
+    local start=$(date +%s%N)
+    for unit in $(seq "${UNITS}"); do
+        ${CXX} -std=c++20 "${level}" -c -I"${ROOT}/expected/include" -DHEADER="\"${header}\"" \
+            "${WORK}/unit${unit}.cpp" -o "${WORK}/unit${unit}.o"
+    done
+    if [[ -n "${library}" ]]; then
+        ${CXX} -std=c++20 "${level}" -c -I"${ROOT}/expected/include" "${library}" -o "${WORK}/library.o"
+    fi
+    local end=$(date +%s%N)
+
+    local bytes=$(cat "${WORK}"/*.o | wc -c)
+    printf '%-4s %-28s %8d ms %10d object bytes\n' "${level}" "${header}" \
+        $(( (end - start) / 1000000 )) "${bytes}"
+}
+
+for level in -O0 -O2; do
+    measure "${level}" expected.h ""
+    measure "${level}" expected_instantiations.h "${ROOT}/expected/src/expected_instantiations.cpp"
+done
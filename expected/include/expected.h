@@ -1,14 +1,40 @@
 #pragma once
 
+#include "expected_fwd.h"
+
+#include <cstdint>
 #include <exception>
-#include <iostream>
+#include <memory>
 #include <type_traits>
 #include <utility>
 
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+#include <compare>
+#define PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON 1
+#endif
+
+/// Members that change the active alternative are only usable in constant expressions once
+/// std::construct_at and constexpr destructors are available (C++20)
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+#define PSTD_EXPECTED_CONSTEXPR20 constexpr
+#else
+#define PSTD_EXPECTED_CONSTEXPR20
+#endif
+
 namespace pstd {
 
 namespace detail {
 
+/// Constructs an object in uninitialized storage, in a constant expression when supported
+template <typename T, typename ... Args>
+PSTD_EXPECTED_CONSTEXPR20 void construct_at(T *location, Args && ... args) {
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    std::construct_at(location, std::forward<Args>(args)...);
+#else
+    ::new (static_cast<void *>(location)) T(std::forward<Args>(args)...);
+#endif
+}
+
 class bad_optional_access : public std::exception {
   public:
     explicit bad_optional_access(const char* const error) : error_(error) {
@@ -23,7 +49,7 @@ class bad_optional_access : public std::exception {
 };
 
 template <typename ExceptionType>
-void throw_exception([[maybe_unused]] const bool condition,
+constexpr void throw_exception([[maybe_unused]] const bool condition,
                      [[maybe_unused]] const char *error) {
 #ifndef PSTD_EXPECTED_DISABLE_EXCEPTIONS
     if (condition) {
@@ -53,16 +79,100 @@ struct is_comparable<A, B,
 template <typename A, typename B = A>
 constexpr bool is_comparable_v = is_comparable<A, B>::value;
 
+template <typename T>
+struct is_expected : std::false_type {};
+
+template <typename ValueType, typename ErrorType>
+struct is_expected<expected<ValueType, ErrorType>> : std::true_type {};
+
+template <typename T>
+struct is_unexpected : std::false_type {};
+
+template <typename ErrorType>
+struct is_unexpected<unexpected<ErrorType>> : std::true_type {};
+
+/// Whether [T] could be made from an [expected] as a whole, in which case converting from that
+/// [expected] alternative by alternative would be ambiguous
+template <typename T, typename Expected>
+constexpr bool is_constructible_from_expected_v =
+    std::is_constructible_v<T, Expected &> || std::is_constructible_v<T, Expected &&> ||
+    std::is_constructible_v<T, const Expected &> || std::is_constructible_v<T, const Expected &&> ||
+    std::is_convertible_v<Expected &, T> || std::is_convertible_v<Expected &&, T> ||
+    std::is_convertible_v<const Expected &, T> || std::is_convertible_v<const Expected &&, T>;
+
+/// Whether expected<ValueType, ErrorType> can be converted from expected<U, G>, where [UArg] and
+/// [GArg] are [U] and [G] with the value category of the source, as specified by P0323
+template <typename ValueType, typename ErrorType, typename U, typename G, typename UArg, typename GArg>
+constexpr bool is_expected_convertible_v =
+    !(std::is_same_v<ValueType, U> && std::is_same_v<ErrorType, G>) &&
+    std::is_constructible_v<ValueType, UArg> && std::is_constructible_v<ErrorType, GArg> &&
+    !is_constructible_from_expected_v<ValueType, expected<U, G>> &&
+    !is_constructible_from_expected_v<unexpected<ErrorType>, expected<U, G>>;
+
+/// Whether the conversion above is implicit
+template <typename ValueType, typename ErrorType, typename UArg, typename GArg>
+constexpr bool is_expected_implicitly_convertible_v =
+    std::is_convertible_v<UArg, ValueType> && std::is_convertible_v<GArg, ErrorType>;
+
+/// Whether [U] is a bare value that [ValueType] can be compared with, the wrappers are excluded first
+/// so that the comparison is never considered for them
+template <typename ValueType, typename U>
+constexpr bool is_value_comparable_v = std::conjunction_v<std::negation<is_expected<U>>,
+                                                          std::negation<is_unexpected<U>>,
+                                                          is_equality_comparable<const ValueType &, const U &>>;
+
+#if defined(PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON)
+/// Three way comparison that falls back to [operator<] for types without [operator<=>]
+template <typename T>
+constexpr auto synth_three_way(const T &a, const T &b) {
+    if constexpr (std::three_way_comparable<T>) {
+        return a <=> b;
+    } else {
+        return (a < b) ? std::weak_ordering::less :
+               (b < a) ? std::weak_ordering::greater :
+                         std::weak_ordering::equivalent;
+    }
+}
+
+template <typename T>
+using synth_three_way_result_t = decltype(synth_three_way(std::declval<const T &>(), std::declval<const T &>()));
+
+/// Integral and enum payloads which fit in the low half of an [ordering_key]
+template <typename T>
+constexpr bool has_ordering_key_v = (std::is_integral_v<T> || std::is_enum_v<T>) && (sizeof(T) <= sizeof(std::uint32_t));
+
+/// Maps a payload to unsigned bits with the same ordering, by flipping the sign bit of signed types
+template <typename T>
+constexpr std::uint32_t ordering_bits(const T value) {
+    if constexpr (std::is_enum_v<T>) {
+        return ordering_bits(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<std::uint32_t>(static_cast<std::int32_t>(value)) ^ 0x8000'0000U;
+    } else {
+        return static_cast<std::uint32_t>(value);
+    }
+}
+
+/// Packs the state above the payload, so that one unsigned comparison orders values before errors
+/// and then by payload, the selection between value and error compiles to a conditional move
+template <typename Expected>
+constexpr std::uint64_t ordering_key(const Expected &e) {
+    const std::uint64_t payload = (e.has_value()) ? (ordering_bits(*e)) : (ordering_bits(e.error()));
+    return (static_cast<std::uint64_t>(!e.has_value()) << 32U) | payload;
+}
+#endif
+
 } // namespace detail
 
 /// Represents an "unexpected" object or the E / Error of an [expected] object
-template <typename ErrorType,
-            std::enable_if_t<!std::is_reference_v<ErrorType>> * = nullptr,
-            std::enable_if_t<!std::is_void_v<ErrorType>> * = nullptr>
+template <typename ErrorType>
 class unexpected {
   public:
+    static_assert(!std::is_reference_v<ErrorType>, "Error type must not be a reference");
+    static_assert(!std::is_void_v<ErrorType>, "Error type must not be void");
+
     using Type = ErrorType;
-    using SelfType = unexpected<ErrorType>;
+    using SelfType = unexpected;
 
     /// Disable default constructor to prevent implicit conversions
     unexpected() = delete;
@@ -72,7 +182,8 @@ class unexpected {
     constexpr explicit unexpected(ErrorType &&error) : error_(std::move(error)) {}
 
     /// Perfect forwarding constructor
-    template <typename ... Args>
+    template <typename ... Args,
+                std::enable_if_t<std::is_constructible_v<ErrorType, Args && ...>> * = nullptr>
     constexpr unexpected(Args && ... args) : error_(std::forward<Args>(args)...) {}
 
     ~unexpected() = default;
@@ -82,119 +193,300 @@ class unexpected {
     constexpr unexpected(SelfType &&other) = default;
     constexpr SelfType &operator=(const SelfType &other) = default;
 
-    constexpr ErrorType &value() { return error_; }
-    constexpr const ErrorType &value() const { return error_; }
+    constexpr ErrorType &value() & { return error_; }
+    constexpr const ErrorType &value() const & { return error_; }
+    constexpr ErrorType &&value() && { return std::move(error_); }
+    constexpr const ErrorType &&value() const && { return std::move(error_); }
 
   private:
     /// Value of this object
     ErrorType error_;
 };
 
+namespace detail {
+
+/// Tag to leave [expected_storage] without an active member, the owner must construct one
+struct uninitialized_t {};
+
+/// Tag for an [expected] which stores its own address, so that a coroutine can write its result there
+struct result_slot_t {};
+
+/// Converts the return object of a coroutine into its [expected], the only user of [result_slot_t]
+template <typename ValueType, typename ErrorType>
+class expected_return_object;
+
+/// Storage of [expected], which is only given a destructor when one of the alternatives needs it,
+/// so that trivially destructible alternatives produce a literal type usable in constant expressions
 template <typename ValueType, typename ErrorType,
-            std::enable_if_t<std::is_nothrow_constructible_v<ErrorType>> * = nullptr>
-class expected {
-    using SelfType = expected<ValueType, ErrorType>;
+            bool = std::is_trivially_destructible_v<ValueType> &&
+                   std::is_trivially_destructible_v<ErrorType>>
+class expected_storage {
+  protected:
+    /// Value initializes the error, which is the documented default state
+    constexpr expected_storage() noexcept : error_(ErrorType{}), has_value_(false) {}
+
+    constexpr explicit expected_storage(uninitialized_t) noexcept : has_value_(false) {}
+
+    template <typename ... Args>
+    constexpr explicit expected_storage(std::in_place_index_t<0>, Args && ... args)
+        : value_(std::forward<Args>(args)...), has_value_(true) {}
+
+    template <typename ... Args>
+    constexpr explicit expected_storage(std::in_place_index_t<1>, Args && ... args)
+        : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+    /// Destroys the active member, leaving the storage uninitialized
+    constexpr void destroy() noexcept {}
+
+    union {
+        ValueType value_;
+        unexpected<ErrorType> error_;
+    };
+
+    bool has_value_;
+};
+
+template <typename ValueType, typename ErrorType>
+class expected_storage<ValueType, ErrorType, false> {
+  protected:
+    /// Value initializes the error, which is the documented default state
+    constexpr expected_storage() noexcept : error_(ErrorType{}), has_value_(false) {}
+
+    constexpr explicit expected_storage(uninitialized_t) noexcept : has_value_(false) {}
+
+    template <typename ... Args>
+    constexpr explicit expected_storage(std::in_place_index_t<0>, Args && ... args)
+        : value_(std::forward<Args>(args)...), has_value_(true) {}
+
+    template <typename ... Args>
+    constexpr explicit expected_storage(std::in_place_index_t<1>, Args && ... args)
+        : error_(std::forward<Args>(args)...), has_value_(false) {}
+
+    PSTD_EXPECTED_CONSTEXPR20 ~expected_storage() noexcept {
+        destroy();
+    }
+
+    /// Destroys the active member, leaving the storage uninitialized
+    PSTD_EXPECTED_CONSTEXPR20 void destroy() noexcept {
+        if (has_value_) {
+            std::destroy_at(std::addressof(value_));
+        } else {
+            std::destroy_at(std::addressof(error_));
+        }
+    }
+
+    union {
+        ValueType value_;
+        unexpected<ErrorType> error_;
+    };
+
+    bool has_value_;
+};
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+class expected : private detail::expected_storage<ValueType, ErrorType> {
+    using SelfType = expected;
+    using StorageType = detail::expected_storage<ValueType, ErrorType>;
+
+    using StorageType::value_;
+    using StorageType::error_;
+    using StorageType::has_value_;
 
   public:
+    using value_type = ValueType;
+    using error_type = ErrorType;
+    using unexpected_type = unexpected<ErrorType>;
+
     static_assert(std::is_default_constructible_v<ValueType>, "Value type must be default constructible");
+    static_assert(std::is_nothrow_constructible_v<ErrorType>, "Error type must be nothrow default constructible");
 
     /// Tag to specify in place construction of [ValueType]
-    struct in_place {};
+    using in_place = in_place_t;
 
     /// Tag to specify in place construction of [ErrorType]
-    struct unexpect {};
+    using unexpect = unexpect_t;
 
-    /// Must be implemented, otherwise default constructor is always implicitly deleted
-    constexpr expected() {}
+    /// Holds a value initialized [ErrorType], which costs no more than a store for trivial errors
+    constexpr expected() noexcept = default;
 
     /// Copy constructor
-    constexpr expected(const SelfType &other) : has_value_(other.has_value_) {
-        set(std::move(other));
+    constexpr expected(const SelfType &other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(other);
     }
 
     /// Move constructor
-    constexpr expected(SelfType &&other) : has_value_(other.has_value_) {
-        set(std::move(other));
+    constexpr expected(SelfType &&other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(std::move(other));
     }
 
-    /// [unexpected] copy constructor
-    template <typename E = ErrorType,
-                std::enable_if_t<std::is_same_v<E, ErrorType>> * = nullptr,
-                std::enable_if_t<std::is_copy_constructible_v<E>> * = nullptr>
-    constexpr expected(const unexpected<ErrorType> &error) : error_(error), has_value_(false){}
+    /// Converting copy constructor, constructs the active alternative directly from the source
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, const U &, const G &>> * = nullptr,
+                std::enable_if_t<detail::is_expected_implicitly_convertible_v<ValueType, ErrorType, const U &, const G &>> * = nullptr>
+    constexpr expected(const expected<U, G> &other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(other);
+    }
+
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, const U &, const G &>> * = nullptr,
+                std::enable_if_t<!detail::is_expected_implicitly_convertible_v<ValueType, ErrorType, const U &, const G &>> * = nullptr>
+    constexpr explicit expected(const expected<U, G> &other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(other);
+    }
+
+    /// Converting move constructor, constructs the active alternative directly from the source
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, U &&, G &&>> * = nullptr,
+                std::enable_if_t<detail::is_expected_implicitly_convertible_v<ValueType, ErrorType, U &&, G &&>> * = nullptr>
+    constexpr expected(expected<U, G> &&other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(std::move(other));
+    }
+
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, U &&, G &&>> * = nullptr,
+                std::enable_if_t<!detail::is_expected_implicitly_convertible_v<ValueType, ErrorType, U &&, G &&>> * = nullptr>
+    constexpr explicit expected(expected<U, G> &&other) : StorageType(detail::uninitialized_t{}) {
+        construct_from(std::move(other));
+    }
+
+    /// [unexpected] copy constructor, constructs [ErrorType] directly from the wrapped error
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, const G &>> * = nullptr,
+                std::enable_if_t<std::is_convertible_v<const G &, ErrorType>> * = nullptr>
+    constexpr expected(const unexpected<G> &error) : StorageType(std::in_place_index<1>, error.value()) {}
+
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, const G &>> * = nullptr,
+                std::enable_if_t<!std::is_convertible_v<const G &, ErrorType>> * = nullptr>
+    constexpr explicit expected(const unexpected<G> &error) : StorageType(std::in_place_index<1>, error.value()) {}
+
+    /// [unexpected] move constructor, constructs [ErrorType] directly from the wrapped error
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, G &&>> * = nullptr,
+                std::enable_if_t<std::is_convertible_v<G &&, ErrorType>> * = nullptr>
+    constexpr expected(unexpected<G> &&error) : StorageType(std::in_place_index<1>, std::move(error).value()) {}
+
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, G &&>> * = nullptr,
+                std::enable_if_t<!std::is_convertible_v<G &&, ErrorType>> * = nullptr>
+    constexpr explicit expected(unexpected<G> &&error) : StorageType(std::in_place_index<1>, std::move(error).value()) {}
 
     /// [ValueType] move constructor
     template <typename V = ValueType,
                 std::enable_if_t<std::is_same_v<V, ValueType>> * = nullptr,
                 std::enable_if_t<std::is_move_constructible_v<V>> * = nullptr>
-    constexpr expected(V &&value) : value_(std::move(value)), has_value_(true) {}
+    constexpr expected(V &&value) : StorageType(std::in_place_index<0>, std::move(value)) {}
 
     /// [ValueType] copy constructor
     template <typename V = ValueType,
                 std::enable_if_t<std::is_same_v<V, ValueType>> * = nullptr,
                 std::enable_if_t<std::is_copy_constructible_v<V>> * = nullptr>
-    constexpr expected(const V &value) : value_(value), has_value_(true) {}
+    constexpr expected(const V &value) : StorageType(std::in_place_index<0>, value) {}
 
-    /// [ErrorType] move constructor
+    /// [ErrorType] move constructor, only when it differs from [ValueType], use [unexpect] or [unexpected] otherwise
     template <typename E = ErrorType,
-                std::enable_if_t<std::is_same_v<E, ErrorType>> * = nullptr,
+                std::enable_if_t<std::is_same_v<E, ErrorType> && !std::is_same_v<E, ValueType>> * = nullptr,
                 std::enable_if_t<std::is_move_constructible_v<E>> * = nullptr>
-    constexpr expected(E &&error) : error_(std::move(error)), has_value_(false) {}
+    constexpr expected(E &&error) : StorageType(std::in_place_index<1>, std::move(error)) {}
 
-    /// [ErrorType] copy constructor
+    /// [ErrorType] copy constructor, only when it differs from [ValueType], use [unexpect] or [unexpected] otherwise
     template <typename E = ErrorType,
-                std::enable_if_t<std::is_same_v<E, ErrorType>> * = nullptr,
+                std::enable_if_t<std::is_same_v<E, ErrorType> && !std::is_same_v<E, ValueType>> * = nullptr,
                 std::enable_if_t<std::is_copy_constructible_v<E>> * = nullptr>
-    constexpr expected(const E &error) : error_(error), has_value_(false) {}
+    constexpr expected(const E &error) : StorageType(std::in_place_index<1>, error) {}
 
     /// [ValueType] perfect forwarding constructor
     template <typename ... Args,
                 typename V = ValueType,
                 std::enable_if_t<std::is_nothrow_constructible_v<V, Args && ...>> * = nullptr>
-    constexpr expected(in_place, Args && ... args) : value_(std::forward<Args>(args)...), has_value_(true) {}
+    constexpr expected(in_place, Args && ... args) : StorageType(std::in_place_index<0>, std::forward<Args>(args)...) {}
 
     /// [ErrorType] perfect forwarding constructor
     template <typename ... Args,
                 typename E = ErrorType,
                 std::enable_if_t<std::is_nothrow_constructible_v<E, Args && ...>> * = nullptr>
-    constexpr expected(unexpect, Args && ... args) : error_(std::forward<Args>(args)...), has_value_(false) {}
+    constexpr expected(unexpect, Args && ... args) : StorageType(std::in_place_index<1>, std::forward<Args>(args)...) {}
 
-    /// Destructor
-    ~expected() noexcept {
-        if (has_value_) {
-            value_.~ValueType();
-        } else {
-            error_.~decltype(error_)();
-        }
-    }
+    /// Destructor, trivial when both [ValueType] and [ErrorType] are
+    ~expected() = default;
 
     /// [ValueType] copy assignment operator
-    SelfType &operator=(ValueType value) {
-        set(std::move(value));
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(ValueType value) {
+        set_value(std::move(value));
+        return *this;
+    }
+
+    /// [ErrorType] copy assignment operator, only when it differs from [ValueType], assign an [unexpected] otherwise
+    template <typename V = ValueType,
+                std::enable_if_t<!std::is_same_v<V, ErrorType>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(ErrorType error) {
+        set_error(std::move(error));
+        return *this;
+    }
+
+    /// [unexpected] copy assignment operator, assigns or constructs [ErrorType] from the wrapped error
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, const G &> &&
+                                 std::is_assignable_v<ErrorType &, const G &>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(const unexpected<G> &error) {
+        set_error(error.value());
         return *this;
     }
 
-    /// [ErrorType] copy assignment operator
-    SelfType &operator=(ErrorType error) {
-        set(std::move(error));
+    /// [unexpected] move assignment operator, assigns or constructs [ErrorType] from the wrapped error
+    template <typename G,
+                std::enable_if_t<std::is_constructible_v<ErrorType, G &&> &&
+                                 std::is_assignable_v<ErrorType &, G &&>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(unexpected<G> &&error) {
+        set_error(std::move(error).value());
         return *this;
     }
 
     /// Copy assignment operator
-    SelfType &operator=(SelfType other) {
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(SelfType other) {
         set(std::move(other));
         return *this;
     }
 
+    /// Converting copy assignment operator, assigns in place when the alternatives match
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, const U &, const G &>> * = nullptr,
+                std::enable_if_t<std::is_assignable_v<ValueType &, const U &> &&
+                                 std::is_assignable_v<ErrorType &, const G &>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(const expected<U, G> &other) {
+        assign_from(other);
+        return *this;
+    }
+
+    /// Converting move assignment operator, assigns in place when the alternatives match
+    template <typename U, typename G,
+                std::enable_if_t<detail::is_expected_convertible_v<ValueType, ErrorType, U, G, U &&, G &&>> * = nullptr,
+                std::enable_if_t<std::is_assignable_v<ValueType &, U &&> &&
+                                 std::is_assignable_v<ErrorType &, G &&>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 SelfType &operator=(expected<U, G> &&other) {
+        assign_from(std::move(other));
+        return *this;
+    }
+
     /// Dereference operator
-    [[nodiscard]] constexpr ValueType &operator*() {
+    [[nodiscard]] constexpr ValueType &operator*() & {
         detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
         return value_;
     }
-    [[nodiscard]] constexpr const ValueType &operator*() const {
+    [[nodiscard]] constexpr const ValueType &operator*() const & {
         detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
         return value_;
     }
+    [[nodiscard]] constexpr ValueType &&operator*() && {
+        detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
+        return std::move(value_);
+    }
+    [[nodiscard]] constexpr const ValueType &&operator*() const && {
+        detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
+        return std::move(value_);
+    }
     [[nodiscard]] constexpr ValueType *operator->() {
         detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
         return std::addressof(value_);
@@ -205,28 +497,44 @@ class expected {
     }
 
     /// Check for existence of value
-    [[nodiscard]] constexpr operator bool() const noexcept { return has_value(); }
+    [[nodiscard]] constexpr explicit operator bool() const noexcept { return has_value(); }
     [[nodiscard]] constexpr bool has_value() const noexcept { return has_value_; }
 
     /// Get the value
-    [[nodiscard]] ValueType &value() {
+    [[nodiscard]] constexpr ValueType &value() & {
         detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
         return value_;
     }
-    [[nodiscard]] const ValueType &value() const {
+    [[nodiscard]] constexpr const ValueType &value() const & {
         detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
         return value_;
     }
+    [[nodiscard]] constexpr ValueType &&value() && {
+        detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
+        return std::move(value_);
+    }
+    [[nodiscard]] constexpr const ValueType &&value() const && {
+        detail::throw_exception<detail::bad_optional_access>(!has_value_, "Object does not have a value");
+        return std::move(value_);
+    }
 
     /// Get the error
-    [[nodiscard]] ErrorType &error() {
+    [[nodiscard]] constexpr ErrorType &error() & {
         detail::throw_exception<detail::bad_optional_access>(has_value_, "Object does not have an error");
         return error_.value();
     }
-    [[nodiscard]] const ErrorType &error() const {
+    [[nodiscard]] constexpr const ErrorType &error() const & {
         detail::throw_exception<detail::bad_optional_access>(has_value_, "Object does not have an error");
         return error_.value();
     }
+    [[nodiscard]] constexpr ErrorType &&error() && {
+        detail::throw_exception<detail::bad_optional_access>(has_value_, "Object does not have an error");
+        return std::move(error_).value();
+    }
+    [[nodiscard]] constexpr const ErrorType &&error() const && {
+        detail::throw_exception<detail::bad_optional_access>(has_value_, "Object does not have an error");
+        return std::move(error_).value();
+    }
 
     [[nodiscard]] constexpr ValueType value_or(ValueType &&alternative) const noexcept {
         return (has_value_) ? (value_) : (std::move(alternative));
@@ -246,66 +554,136 @@ class expected {
 
     /// Constructs a ValueType in place, destroying the previous object
     template <typename ... Args>
-    void emplace(in_place, Args && ... args) {
-        if (has_value_) {
-            value_.~ValueType();
-        } else {
-            error_.~decltype(error_)();
-        }
-
-        ::new (std::addressof(value_)) ValueType(std::forward<Args>(args)...);
+    PSTD_EXPECTED_CONSTEXPR20 ValueType &emplace(in_place, Args && ... args) {
+        this->destroy();
+        detail::construct_at(std::addressof(value_), std::forward<Args>(args)...);
         has_value_ = true;
+        return value_;
     }
 
     /// Constructs a ErrorType in place, destroying the previous object
     template <typename ... Args>
-    void emplace(unexpect, Args && ... args) {
+    PSTD_EXPECTED_CONSTEXPR20 ErrorType &emplace(unexpect, Args && ... args) {
+        this->destroy();
+        detail::construct_at(std::addressof(error_), std::forward<Args>(args)...);
+        has_value_ = false;
+        return error_.value();
+    }
+
+    /// Assigns to the held ValueType, so that it keeps any resources such as capacity, otherwise
+    /// constructs a ValueType in place of the error
+    template <typename U,
+                std::enable_if_t<std::is_constructible_v<ValueType, U &&> &&
+                                 std::is_assignable_v<ValueType &, U &&>> * = nullptr>
+    PSTD_EXPECTED_CONSTEXPR20 ValueType &assign_or_emplace(U &&value) {
         if (has_value_) {
-            value_.~ValueType();
-        } else {
-            error_.~decltype(error_)();
+            value_ = std::forward<U>(value);
+            return value_;
         }
-
-        ::new (std::addressof(error_)) unexpected<ErrorType>(std::forward<Args>(args)...);
-        has_value_ = false;
+        return emplace(in_place{}, std::forward<U>(value));
     }
 
   private:
-    union {
-        ValueType value_;
-        unexpected<ErrorType> error_;
-    };
+    /// Allow conversions to reach the storage of other specializations
+    template <typename, typename>
+    friend class expected;
+
+    /// Allow a coroutine return object to hand the promise the address of the converted [expected]
+    friend class detail::expected_return_object<ValueType, ErrorType>;
+
+    /// Holds a value initialized [ErrorType] and points [slot] at itself
+    constexpr expected(detail::result_slot_t, SelfType *&slot) noexcept : expected() {
+        slot = this;
+    }
+
+    /// Constructs the same alternative as [other], which may be any [expected], into uninitialized storage
+    template <typename Other>
+    PSTD_EXPECTED_CONSTEXPR20 void construct_from(Other &&other) {
+        if (other.has_value_) {
+            detail::construct_at(std::addressof(value_), std::forward<Other>(other).value_);
+            has_value_ = true;
+        } else {
+            detail::construct_at(std::addressof(error_), std::forward<Other>(other).error_.value());
+            has_value_ = false;
+        }
+    }
+
+    /// Assigns into the active alternative when it matches [other], otherwise reconstructs
+    template <typename Other>
+    PSTD_EXPECTED_CONSTEXPR20 void assign_from(Other &&other) {
+        if (has_value_ && other.has_value_) {
+            value_ = std::forward<Other>(other).value_;
+        } else if (!has_value_ && !other.has_value_) {
+            error_.value() = std::forward<Other>(other).error_.value();
+        } else if (other.has_value_) {
+            reconstruct<ValueType>(std::addressof(value_), true, std::forward<Other>(other).value_);
+        } else {
+            reconstruct<ErrorType>(std::addressof(error_), false, std::forward<Other>(other).error_.value());
+        }
+    }
 
-    bool has_value_ = false;
+    /// Replaces the active alternative with a [Type] built from [source] at [member]
+    ///
+    /// A throwing conversion happens on a temporary and leaves this object unchanged, a throwing move of
+    /// that temporary leaves this object holding a value initialized [ErrorType], so the destructor
+    /// never sees a destroyed alternative
+    template <typename Type, typename Member, typename Source>
+    PSTD_EXPECTED_CONSTEXPR20 void reconstruct(Member *member, const bool has_value, Source &&source) {
+        struct reset_guard {
+            expected *self;
+            PSTD_EXPECTED_CONSTEXPR20 ~reset_guard() {
+                if (self) {
+                    detail::construct_at(std::addressof(self->error_), ErrorType{});
+                    self->has_value_ = false;
+                }
+            }
+        };
+
+        if constexpr (std::is_nothrow_constructible_v<Type, Source &&>) {
+            this->destroy();
+            detail::construct_at(member, std::forward<Source>(source));
+        } else {
+            Type temporary(std::forward<Source>(source));
+            this->destroy();
+            reset_guard guard{this};
+            detail::construct_at(member, std::move(temporary));
+            guard.self = nullptr;
+        }
+        has_value_ = has_value;
+    }
 
-    void set(SelfType &&other) {
+    PSTD_EXPECTED_CONSTEXPR20 void set(SelfType &&other) {
         if (other.has_value_) {
-            set(std::move(other.value_));
+            set_value(std::move(other.value_));
         } else {
-            set(std::move(other.error_.value()));
+            set_error(std::move(other.error_.value()));
         }
     }
 
-    void set(ErrorType error) {
+    /// Assigns the error in place, or constructs it in place of the value
+    template <typename G>
+    PSTD_EXPECTED_CONSTEXPR20 void set_error(G &&error) {
         if (has_value_) {
             // Destruct value
-            value_.~ValueType();
+            this->destroy();
             // Set error
-            ::new (std::addressof(error_)) unexpected<ErrorType>(std::move(error));
+            detail::construct_at(std::addressof(error_), std::forward<G>(error));
             has_value_ = false;
         } else {
-            error_ = std::move(error);
+            error_.value() = std::forward<G>(error);
         }
     }
 
-    void set(ValueType value) {
+    /// Assigns the value in place, or constructs it in place of the error
+    template <typename V>
+    PSTD_EXPECTED_CONSTEXPR20 void set_value(V &&value) {
         if (has_value_) {
-            value_ = std::move(value);
+            value_ = std::forward<V>(value);
         } else {
             // Destruct error
-            error_.~decltype(error_)();
+            this->destroy();
             // Set value
-            ::new (std::addressof(value_)) ValueType(std::move(value));
+            detail::construct_at(std::addressof(value_), std::forward<V>(value));
             has_value_ = true;
         }
     }
@@ -320,7 +698,7 @@ constexpr unexpected<ErrorType> make_unexpected(Args && ... args) {
 template <typename ValueType, typename ErrorType,
             std::enable_if_t<std::is_move_constructible_v<ValueType>> * = nullptr,
             std::enable_if_t<std::is_move_constructible_v<ErrorType>> * = nullptr>
-void swap(expected<ValueType, ErrorType> &a,
+PSTD_EXPECTED_CONSTEXPR20 void swap(expected<ValueType, ErrorType> &a,
           expected<ValueType, ErrorType> &b) {
     expected<ValueType, ErrorType> temp = std::move(a);
     a = std::move(b);
@@ -341,6 +719,15 @@ constexpr bool operator!=(const unexpected<ErrorType> &a,
     return !(operator==(a, b));
 }
 
+#if defined(PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON)
+/// Orders by the errors, [operator<] [operator<=] [operator>] [operator>=] are rewritten to this
+template <typename ErrorType,
+            std::enable_if_t<detail::is_comparable_v<ErrorType>> * = nullptr>
+constexpr auto operator<=>(const unexpected<ErrorType> &a,
+                           const unexpected<ErrorType> &b) {
+    return detail::synth_three_way(a.value(), b.value());
+}
+#else
 template <typename ErrorType,
             std::enable_if_t<detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator<(const unexpected<ErrorType> &a,
@@ -352,22 +739,23 @@ template <typename ErrorType,
             std::enable_if_t<detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator<=(const unexpected<ErrorType> &a,
                           const unexpected<ErrorType> &b) {
-    return (operator<(a, b)) || (operator==(a, b));
+    return !(operator<(b, a));
 }
 
 template <typename ErrorType,
             std::enable_if_t<detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator>(const unexpected<ErrorType> &a,
                          const unexpected<ErrorType> &b) {
-    return !(operator<(a, b));
+    return (operator<(b, a));
 }
 
 template <typename ErrorType,
             std::enable_if_t<detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator>=(const unexpected<ErrorType> &a,
                           const unexpected<ErrorType> &b) {
-    return (operator>(a, b)) || (operator==(a, b));
+    return !(operator<(a, b));
 }
+#endif
 
 template <typename ValueType, typename ErrorType,
             std::enable_if_t<detail::is_equality_comparable_v<ValueType> &&
@@ -391,6 +779,80 @@ constexpr bool operator!=(const expected<ValueType, ErrorType> &a,
     return !(operator==(a, b));
 }
 
+/// Compares against a bare value without converting it to [expected]
+template <typename ValueType, typename ErrorType, typename U,
+            std::enable_if_t<detail::is_value_comparable_v<ValueType, U>> * = nullptr>
+constexpr bool operator==(const expected<ValueType, ErrorType> &a, const U &b) {
+    return (a.has_value()) && (*a == b);
+}
+
+/// Compares against an error without converting it to [expected]
+template <typename ValueType, typename ErrorType, typename G,
+            std::enable_if_t<detail::is_equality_comparable_v<const ErrorType &, const G &>> * = nullptr>
+constexpr bool operator==(const expected<ValueType, ErrorType> &a, const unexpected<G> &b) {
+    return (!a.has_value()) && (a.error() == b.value());
+}
+
+#if !defined(PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON)
+/// Before C++20 the reversed and negated forms are not rewritten from [operator==]
+template <typename ValueType, typename ErrorType, typename U,
+            std::enable_if_t<detail::is_value_comparable_v<ValueType, U>> * = nullptr>
+constexpr bool operator==(const U &a, const expected<ValueType, ErrorType> &b) {
+    return (operator==(b, a));
+}
+
+template <typename ValueType, typename ErrorType, typename U,
+            std::enable_if_t<detail::is_value_comparable_v<ValueType, U>> * = nullptr>
+constexpr bool operator!=(const expected<ValueType, ErrorType> &a, const U &b) {
+    return !(operator==(a, b));
+}
+
+template <typename ValueType, typename ErrorType, typename U,
+            std::enable_if_t<detail::is_value_comparable_v<ValueType, U>> * = nullptr>
+constexpr bool operator!=(const U &a, const expected<ValueType, ErrorType> &b) {
+    return !(operator==(b, a));
+}
+
+template <typename ValueType, typename ErrorType, typename G,
+            std::enable_if_t<detail::is_equality_comparable_v<const ErrorType &, const G &>> * = nullptr>
+constexpr bool operator==(const unexpected<G> &a, const expected<ValueType, ErrorType> &b) {
+    return (operator==(b, a));
+}
+
+template <typename ValueType, typename ErrorType, typename G,
+            std::enable_if_t<detail::is_equality_comparable_v<const ErrorType &, const G &>> * = nullptr>
+constexpr bool operator!=(const expected<ValueType, ErrorType> &a, const unexpected<G> &b) {
+    return !(operator==(a, b));
+}
+
+template <typename ValueType, typename ErrorType, typename G,
+            std::enable_if_t<detail::is_equality_comparable_v<const ErrorType &, const G &>> * = nullptr>
+constexpr bool operator!=(const unexpected<G> &a, const expected<ValueType, ErrorType> &b) {
+    return !(operator==(b, a));
+}
+#endif
+
+#if defined(PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON)
+/// Orders every value before every error, then by the active member
+/// [operator<] [operator<=] [operator>] [operator>=] are rewritten to this
+template <typename ValueType, typename ErrorType,
+            std::enable_if_t<detail::is_comparable_v<ValueType> &&
+                             detail::is_comparable_v<ErrorType>> * = nullptr>
+constexpr auto operator<=>(const expected<ValueType, ErrorType> &a,
+                           const expected<ValueType, ErrorType> &b) {
+    using Ordering = std::common_comparison_category_t<detail::synth_three_way_result_t<ValueType>,
+                                                       detail::synth_three_way_result_t<ErrorType>>;
+    if constexpr (detail::has_ordering_key_v<ValueType> && detail::has_ordering_key_v<ErrorType>) {
+        return Ordering(detail::ordering_key(a) <=> detail::ordering_key(b));
+    } else {
+        if (a.has_value() != b.has_value()) {
+            return Ordering(b.has_value() <=> a.has_value());
+        }
+        return (a.has_value()) ? Ordering(detail::synth_three_way(*a, *b)) :
+                                 Ordering(detail::synth_three_way(a.error(), b.error()));
+    }
+}
+#else
 template <typename ValueType, typename ErrorType,
             std::enable_if_t<detail::is_comparable_v<ValueType> &&
                              detail::is_comparable_v<ErrorType>> * = nullptr>
@@ -414,7 +876,7 @@ template <typename ValueType, typename ErrorType,
                              detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator<=(const expected<ValueType, ErrorType> &a,
                           const expected<ValueType, ErrorType> &b) {
-    return (operator<(a, b)) || (operator==(a, b));
+    return !(operator<(b, a));
 }
 
 template <typename ValueType, typename ErrorType,
@@ -422,7 +884,7 @@ template <typename ValueType, typename ErrorType,
                              detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator>(const expected<ValueType, ErrorType> &a,
                          const expected<ValueType, ErrorType> &b) {
-    return !(operator<(a, b));
+    return (operator<(b, a));
 }
 
 template <typename ValueType, typename ErrorType,
@@ -430,7 +892,47 @@ template <typename ValueType, typename ErrorType,
                              detail::is_comparable_v<ErrorType>> * = nullptr>
 constexpr bool operator>=(const expected<ValueType, ErrorType> &a,
                           const expected<ValueType, ErrorType> &b) {
-    return (operator>(a, b)) || (operator==(a, b));
+    return !(operator<(a, b));
 }
+#endif
+
+namespace detail {
+
+/// The error of [result] as an [unexpected], copied or moved along with [result], for [PSTD_TRY]
+template <typename Expected>
+constexpr unexpected<typename std::decay_t<Expected>::error_type> try_error(Expected &&result) {
+    return unexpected<typename std::decay_t<Expected>::error_type>(std::forward<Expected>(result).error());
+}
+
+} // namespace detail
 
 } // namespace pstd
+
+/// Evaluates the [expected] given after [var], then either declares [var] holding its value, or returns its
+/// error from the enclosing function, which must return an [expected] (not a deduced type)
+///
+///     PSTD_TRY(config, parse(text));
+///
+/// The error is returned as an [unexpected], converting to the error type of the enclosing function
+/// even when that conversion or the copy of the error can throw, and the value is moved out of the
+/// [expected] when it is an rvalue, so it costs the same as returning [make_unexpected] by hand
+#define PSTD_TRY(var, ...)                                                                          \
+    auto &&pstd_try_##var = (__VA_ARGS__);                                                          \
+    if (!pstd_try_##var.has_value()) {                                                              \
+        return ::pstd::detail::try_error(std::forward<decltype(pstd_try_##var)>(pstd_try_##var));   \
+    }                                                                                               \
+    auto var = *std::forward<decltype(pstd_try_##var)>(pstd_try_##var)
+
+#if defined(__GNUC__)
+/// Expression form of [PSTD_TRY] using the GNU statement expression extension
+///
+///     const auto sum = PSTD_TRY_EXPR(parse(a)) + PSTD_TRY_EXPR(parse(b));
+#define PSTD_TRY_EXPR(...)                                                                          \
+    ({                                                                                              \
+        auto &&pstd_try_result = (__VA_ARGS__);                                                     \
+        if (!pstd_try_result.has_value()) {                                                         \
+            return ::pstd::detail::try_error(std::forward<decltype(pstd_try_result)>(pstd_try_result)); \
+        }                                                                                           \
+        *std::forward<decltype(pstd_try_result)>(pstd_try_result);                                  \
+    })
+#endif
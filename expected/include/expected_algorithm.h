@@ -0,0 +1,182 @@
+#pragma once
+
+#include "expected.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+/// Keeps a function on the error path out of line and out of the way of the hot path
+#if defined(__GNUC__)
+#define PSTD_EXPECTED_COLD [[gnu::cold, gnu::noinline]]
+#else
+#define PSTD_EXPECTED_COLD
+#endif
+
+/// Algorithms over ranges of [expected]
+namespace pstd {
+
+namespace detail {
+
+template <typename Range>
+using range_iterator_t = decltype(std::begin(std::declval<Range &>()));
+
+/// The [expected] type of the elements of [Range]
+template <typename Range>
+using range_expected_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<range_iterator_t<Range> &>())>>;
+
+/// Number of elements of [range] when it can be known without iterating it, otherwise 0
+template <typename Range>
+std::size_t reserve_size(Range &range) {
+    using Category = typename std::iterator_traits<range_iterator_t<Range>>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+        return static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+    } else {
+        return 0;
+    }
+}
+
+/// [element] of [Range], as an rvalue when [Range] is an rvalue
+template <typename Range, typename Element>
+decltype(auto) forward_element(Element &element) {
+    if constexpr (std::is_lvalue_reference_v<Range>) {
+        return (element);
+    } else {
+        return std::move(element);
+    }
+}
+
+/// The error type shared by the [expected] types [Expecteds]
+template <typename ... Expecteds>
+struct common_error {
+    static_assert(sizeof...(Expecteds) > 0, "at least one expected is needed");
+    static_assert((is_expected<std::decay_t<Expecteds>>::value && ...), "arguments must be expected");
+    using type = typename std::decay_t<std::tuple_element_t<0, std::tuple<Expecteds...>>>::error_type;
+    static_assert((std::is_same_v<typename std::decay_t<Expecteds>::error_type, type> && ...),
+                  "arguments must have the same error type");
+};
+
+template <typename ... Expecteds>
+using common_error_t = typename common_error<Expecteds...>::type;
+
+/// Whether all of [results] have a value, in a single comparison
+///
+/// The states are added up rather than combined with [&&], or even [&] or [|], which GCC still splits
+/// into several branches
+template <typename ... Expecteds>
+constexpr bool all_have_value(const Expecteds & ... results) noexcept {
+    return (static_cast<unsigned>(results.has_value()) + ...) == sizeof...(Expecteds);
+}
+
+/// The error of the first of [results] which has one, one of them must
+template <typename ErrorType, typename ... Expecteds>
+PSTD_EXPECTED_COLD unexpected<ErrorType> first_error(Expecteds && ... results) {
+    ErrorType error{};
+    static_cast<void>(((!results.has_value() && (error = std::forward<Expecteds>(results).error(), true)) || ...));
+    return unexpected<ErrorType>(std::move(error));
+}
+
+} // namespace detail
+
+/// All the values of [range] in a vector, or its first error
+///
+///     std::vector<pstd::expected<Row, Error>> rows = ...;
+///     pstd::expected<std::vector<Row>, Error> table = pstd::collect(std::move(rows));
+///
+/// The vector is reserved up front when the size of [range] is known, and each value is copied, or
+/// moved when [range] is an rvalue, exactly once
+template <typename Range>
+auto collect(Range &&range) {
+    using ExpectedType = detail::range_expected_t<Range>;
+    using ValueType = typename ExpectedType::value_type;
+    using ErrorType = typename ExpectedType::error_type;
+    using ResultType = expected<std::vector<ValueType>, ErrorType>;
+
+    std::vector<ValueType> values;
+    values.reserve(detail::reserve_size(range));
+    for (auto &element : range) {
+        if (!element.has_value()) {
+            return ResultType(unexpected<ErrorType>(detail::forward_element<Range>(element).error()));
+        }
+        values.push_back(*detail::forward_element<Range>(element));
+    }
+    return ResultType(std::move(values));
+}
+
+#if defined(__cpp_lib_span)
+/// Writes the values of [range] to the front of [out] without allocating, returns the part of [out]
+/// written or the first error of [range], wherever it is
+///
+/// Throws [std::length_error] when [range] has no error but more values than fit in [out], the range
+/// is still scanned to the end first so that an error after the values which fit is not missed
+template <typename Range, typename ValueType, std::size_t Extent>
+auto collect(Range &&range, const std::span<ValueType, Extent> out) {
+    using ExpectedType = detail::range_expected_t<Range>;
+    using ErrorType = typename ExpectedType::error_type;
+    using ResultType = expected<std::span<ValueType>, ErrorType>;
+
+    std::size_t size = 0;
+    for (auto &element : range) {
+        if (!element.has_value()) {
+            return ResultType(unexpected<ErrorType>(detail::forward_element<Range>(element).error()));
+        }
+        if (size < out.size()) {
+            out[size] = *detail::forward_element<Range>(element);
+        }
+        size++;
+    }
+    detail::throw_exception<std::length_error>(size > out.size(), "Range has more values than fit in the span");
+    return ResultType(out.first((size < out.size()) ? (size) : (out.size())));
+}
+#endif
+
+/// The values of all [results] in a tuple, or the error of the first which failed
+///
+///     pstd::expected<std::tuple<User, Cart, Price>, Error> order = pstd::zip(user, cart, price);
+///
+/// The states are combined before any of them is branched on, so the group costs one branch however
+/// many [results] there are, and picking the error is kept out of line
+template <typename ... Expecteds>
+auto zip(Expecteds && ... results) {
+    using ErrorType = detail::common_error_t<Expecteds...>;
+    using ValuesType = std::tuple<typename std::decay_t<Expecteds>::value_type...>;
+    using ResultType = expected<ValuesType, ErrorType>;
+
+    if (!detail::all_have_value(results...)) {
+        return ResultType(detail::first_error<ErrorType>(std::forward<Expecteds>(results)...));
+    }
+    return ResultType(ValuesType(*std::forward<Expecteds>(results)...));
+}
+
+/// [f] called with the values of all [results], or the error of the first which failed, an [f]
+/// returning [expected] is not wrapped again
+///
+///     pstd::expected<Order, Error> order = pstd::apply_expected(make_order, user, cart, price);
+///
+/// One branch for the group, as in [zip]
+template <typename F, typename ... Expecteds>
+auto apply_expected(F &&f, Expecteds && ... results) {
+    using ErrorType = detail::common_error_t<Expecteds...>;
+    using InvokeType = std::decay_t<std::invoke_result_t<F, decltype(*std::forward<Expecteds>(results))...>>;
+    static_assert(!std::is_void_v<InvokeType>, "[f] must return a value");
+    using ResultType = std::conditional_t<detail::is_expected<InvokeType>::value, InvokeType,
+                                          expected<InvokeType, ErrorType>>;
+    static_assert(std::is_same_v<typename ResultType::error_type, ErrorType>,
+                  "[f] must return the error type of [results]");
+
+    if (!detail::all_have_value(results...)) {
+        return ResultType(detail::first_error<ErrorType>(std::forward<Expecteds>(results)...));
+    }
+    return ResultType(std::invoke(std::forward<F>(f), *std::forward<Expecteds>(results)...));
+}
+
+} // namespace pstd
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "expected_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/// Exchanges columns of [expected] with code using the Apache Arrow memory layout, without depending on
+/// Arrow
+///
+///     pstd::arrow_column<double, Error> column = pstd::export_arrow(samples);
+///     arrow_array.length = column.length;
+///     arrow_array.null_count = column.null_count;
+///     arrow_array.buffers[0] = column.validity;
+///     arrow_array.buffers[1] = column.values;
+///
+///     pstd::expected_vector<double, Error> copy = pstd::import_arrow(column);
+///
+/// A column is an Arrow primitive array, a values buffer and an LSB first validity bitmap where errors
+/// are nulls, together with an error buffer parallel to the values which Arrow does not know about
+///
+/// [expected_vector] already stores its elements this way, so exporting one copies nothing and
+/// importing copies each buffer in bulk, a [std::vector] of [expected] is converted in a single pass
+///
+///     pstd::arrow_buffers<double, Error> buffers = pstd::export_arrow(results);   // Owns the buffers
+///     std::vector<pstd::expected<double, Error>> copy = pstd::import_arrow_results(buffers.column());
+namespace pstd {
+
+/// Borrowed view of a column of [length] elements in the Arrow layout, element [i] has a value when bit
+/// [i % 8] of byte [i / 8] of [validity] is set, a null [validity] means every element has a value, and
+/// a null [errors] that every error is [ErrorType{}]
+template <typename ValueType, typename ErrorType>
+struct arrow_column {
+    static_assert(std::is_trivially_copyable_v<ValueType>, "Arrow values must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<ErrorType>, "Arrow errors must be trivially copyable");
+
+    std::int64_t length = 0;
+    std::int64_t null_count = 0;
+    const std::uint8_t *validity = nullptr;
+    const ValueType *values = nullptr;
+    const ErrorType *errors = nullptr;
+
+    bool has_value(const std::size_t index) const noexcept {
+        return !validity || ((validity[index / 8] >> (index % 8)) & 1) != 0;
+    }
+
+    /// Element [index] as an [expected]
+    expected<ValueType, ErrorType> operator[](const std::size_t index) const {
+        if (has_value(index)) {
+            return expected<ValueType, ErrorType>(values[index]);
+        }
+        return expected<ValueType, ErrorType>(
+            unexpected<ErrorType>((errors) ? (errors[index]) : (ErrorType{})));
+    }
+};
+
+/// Column viewing the buffers of [vector], valid until [vector] is modified
+///
+/// The bitmap words are LSB first, so on a little endian target their bytes already are an Arrow
+/// validity bitmap, padded to 8 bytes as Arrow recommends
+template <typename ValueType, typename ErrorType>
+arrow_column<ValueType, ErrorType> export_arrow(const expected_vector<ValueType, ErrorType> &vector) noexcept {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the bitmap is only an Arrow bitmap on little endian");
+#endif
+    arrow_column<ValueType, ErrorType> column;
+    column.length = static_cast<std::int64_t>(vector.size());
+    column.null_count = static_cast<std::int64_t>(vector.count_errors());
+    column.validity = reinterpret_cast<const std::uint8_t *>(vector.bitmap());
+    column.values = vector.values();
+    column.errors = vector.errors();
+    return column;
+}
+
+/// Buffers of an [arrow_column] built from a [std::vector] of [expected], which owns them
+template <typename ValueType, typename ErrorType>
+struct arrow_buffers {
+    std::int64_t null_count = 0;
+    /// Padded to a multiple of 8 bytes as Arrow recommends, the padding bits are clear
+    std::vector<std::uint8_t> validity;
+    std::vector<ValueType> values;
+    std::vector<ErrorType> errors;
+
+    /// Column viewing these buffers, valid until they are modified
+    arrow_column<ValueType, ErrorType> column() const noexcept {
+        arrow_column<ValueType, ErrorType> column;
+        column.length = static_cast<std::int64_t>(values.size());
+        column.null_count = null_count;
+        column.validity = validity.data();
+        column.values = values.data();
+        column.errors = errors.data();
+        return column;
+    }
+};
+
+/// Buffers of [results] in a single pass, the value slot of an error holds [ValueType{}] and the
+/// error slot of a value [ErrorType{}]
+template <typename ValueType, typename ErrorType>
+arrow_buffers<ValueType, ErrorType> export_arrow(const std::vector<expected<ValueType, ErrorType>> &results) {
+    static_assert(std::is_trivially_copyable_v<ValueType>, "Arrow values must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<ErrorType>, "Arrow errors must be trivially copyable");
+    arrow_buffers<ValueType, ErrorType> buffers;
+    buffers.validity.resize((results.size() + 63) / 64 * 8);
+    buffers.values.resize(results.size());
+    buffers.errors.resize(results.size());
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const expected<ValueType, ErrorType> &result = results[i];
+        if (result.has_value()) {
+            buffers.values[i] = *result;
+            buffers.validity[i / 8] |= static_cast<std::uint8_t>(1U << (i % 8));
+        } else {
+            buffers.errors[i] = result.error();
+            buffers.null_count++;
+        }
+    }
+    return buffers;
+}
+
+/// Copy of [column] as [expected] results, in a single pass
+template <typename ValueType, typename ErrorType>
+std::vector<expected<ValueType, ErrorType>> import_arrow_results(const arrow_column<ValueType, ErrorType> &column) {
+    std::vector<expected<ValueType, ErrorType>> results;
+    results.reserve(static_cast<std::size_t>(column.length));
+    for (std::size_t i = 0; i < static_cast<std::size_t>(column.length); i++) {
+        results.push_back(column[i]);
+    }
+    return results;
+}
+
+/// Copy of [column] as an [expected_vector]
+template <typename ValueType, typename ErrorType>
+expected_vector<ValueType, ErrorType> import_arrow(const arrow_column<ValueType, ErrorType> &column) {
+    expected_vector<ValueType, ErrorType> vector;
+    vector.append(column.values, column.errors, column.validity, static_cast<std::size_t>(column.length));
+    return vector;
+}
+
+} // namespace pstd
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "expected.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__cpp_lib_atomic_wait) && defined(__SIZEOF_INT128__)
+
+/// [expected] of small trivially copyable types packed into one atomic word, so a result is published
+/// to any number of readers without a lock
+///
+///     const pstd::expected<Offset, Error> pending = pstd::make_unexpected<Error>(Error::Pending);
+///     pstd::atomic_expected<Offset, Error> slot{pending};
+///     slot.store(compute());                                                  // Worker
+///     slot.notify_all();
+///     const pstd::expected<Offset, Error> offset = slot.wait(pending);        // Readers
+///
+/// The payload and the state byte are packed into a 4, 8 or 16 byte word, 16 byte words use a double
+/// width compare and swap (cmpxchg16b) through libatomic, [is_always_lock_free] tells which one a
+/// specialization uses
+///
+/// [compare_exchange_strong] and [wait] compare the packed words, which hold the object representation
+/// of the payload, so payloads must have unique object representations: padding bytes or several
+/// representations of one value, such as floating point, would make equal results compare unequal
+namespace pstd {
+
+namespace detail {
+
+/// Smallest unsigned integer of at least [Size] bytes which has atomic instructions
+template <std::size_t Size>
+struct atomic_word {
+    static_assert(Size <= 16, "[atomic_expected] supports payloads up to 15 bytes");
+    using type = std::conditional_t<(Size <= 4), std::uint32_t,
+                 std::conditional_t<(Size <= 8), std::uint64_t, unsigned __int128>>;
+};
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+class atomic_expected {
+  private:
+    static_assert(std::is_trivially_copyable_v<ValueType>, "ValueType must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<ErrorType>, "ErrorType must be trivially copyable");
+    static_assert(std::has_unique_object_representations_v<ValueType>,
+                  "ValueType must have no padding, its bytes are compared");
+    static_assert(std::has_unique_object_representations_v<ErrorType>,
+                  "ErrorType must have no padding, its bytes are compared");
+
+    static constexpr std::size_t kPayloadSize = (sizeof(ValueType) > sizeof(ErrorType)) ?
+                                                (sizeof(ValueType)) : (sizeof(ErrorType));
+
+    /// Payload bytes first, then the state byte
+    using Word = typename detail::atomic_word<kPayloadSize + 1>::type;
+
+    static constexpr unsigned char kHasValue = 1;
+
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    static constexpr bool is_always_lock_free = std::atomic<Word>::is_always_lock_free;
+
+    /// Holds the default [expected], which is [ErrorType{}]
+    atomic_expected() noexcept : word_(encode(result_type())) {}
+
+    atomic_expected(const result_type &result) noexcept : word_(encode(result)) {}
+
+    atomic_expected(const atomic_expected &) = delete;
+    atomic_expected &operator=(const atomic_expected &) = delete;
+
+    result_type load(const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return decode(word_.load(order));
+    }
+
+    void store(const result_type &desired, const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        word_.store(encode(desired), order);
+    }
+
+    result_type exchange(const result_type &desired,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return decode(word_.exchange(encode(desired), order));
+    }
+
+    /// Replaces the result with [desired] if it is [current], otherwise loads it into [current]
+    bool compare_exchange_strong(result_type &current, const result_type &desired,
+                                 const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        Word word = encode(current);
+        if (word_.compare_exchange_strong(word, encode(desired), order)) {
+            return true;
+        }
+        current = decode(word);
+        return false;
+    }
+
+    bool compare_exchange_weak(result_type &current, const result_type &desired,
+                               const std::memory_order order = std::memory_order_seq_cst) noexcept {
+        Word word = encode(current);
+        if (word_.compare_exchange_weak(word, encode(desired), order)) {
+            return true;
+        }
+        current = decode(word);
+        return false;
+    }
+
+    /// Blocks while the result is [old], returns the result it changed to
+    result_type wait(const result_type &old, const std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        const Word old_word = encode(old);
+        Word word = word_.load(order);
+        while (word == old_word) {
+            word_.wait(old_word, order);
+            word = word_.load(order);
+        }
+        return decode(word);
+    }
+
+    void notify_one() noexcept {
+        word_.notify_one();
+    }
+
+    void notify_all() noexcept {
+        word_.notify_all();
+    }
+
+  private:
+    static Word encode(const result_type &result) noexcept {
+        unsigned char bytes[sizeof(Word)] = {};
+        if (result.has_value()) {
+            std::memcpy(bytes, std::addressof(*result), sizeof(ValueType));
+            bytes[kPayloadSize] = kHasValue;
+        } else {
+            std::memcpy(bytes, std::addressof(result.error()), sizeof(ErrorType));
+        }
+        Word word;
+        std::memcpy(&word, bytes, sizeof(Word));
+        return word;
+    }
+
+    static result_type decode(const Word word) noexcept {
+        unsigned char bytes[sizeof(Word)];
+        std::memcpy(bytes, &word, sizeof(Word));
+        if (bytes[kPayloadSize] == kHasValue) {
+            ValueType value;
+            std::memcpy(std::addressof(value), bytes, sizeof(ValueType));
+            return result_type(value);
+        }
+        ErrorType error;
+        std::memcpy(std::addressof(error), bytes, sizeof(ErrorType));
+        return result_type(unexpected<ErrorType>(error));
+    }
+
+    std::atomic<Word> word_;
+};
+
+} // namespace pstd
+
+#endif
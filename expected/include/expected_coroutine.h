@@ -0,0 +1,197 @@
+#pragma once
+
+#include "expected.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <memory>
+#include <utility>
+
+/// Lets functions returning [expected] be coroutines which [co_await] other [expected] objects
+///
+///     pstd::expected<Config, Error> load(const char *path) {
+///         const std::string text = co_await read(path);   // Returns the error of read() if it failed
+///         co_return co_await parse(text);
+///     }
+///
+/// The coroutine runs eagerly and never suspends except to fail: a failed [co_await] writes the error
+/// into the result and destroys the frame, so no handle ever escapes the call and the frame lifetime
+/// is bounded by the call, which is what allows heap allocation elision (HALO) where the compiler
+/// implements it
+namespace pstd {
+
+namespace detail {
+
+template <typename ValueType, typename ErrorType>
+class expected_promise;
+
+/// Returned from [get_return_object] and converted to the [expected] the coroutine returns
+///
+/// When the conversion happens is unspecified (CWG2563): GCC and Clang convert once the coroutine
+/// returns, so the promise writes into [result_] and the conversion moves it out, MSVC converts before
+/// the body runs, so the conversion hands the promise the address of the converted [expected] itself
+///
+/// Moves re-point the promise at the new object, and the promise detaches from this object when the
+/// coroutine ends, which is how the conversion tells the two orders apart
+template <typename ValueType, typename ErrorType>
+class expected_return_object {
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    explicit expected_return_object(expected_promise<ValueType, ErrorType> &promise) noexcept
+        : promise_(std::addressof(promise)) {
+        attach();
+    }
+
+    expected_return_object(expected_return_object &&other)
+        : result_(std::move(other.result_)), promise_(std::exchange(other.promise_, nullptr)) {
+        if (promise_) {
+            attach();
+        }
+    }
+
+    expected_return_object(const expected_return_object &) = delete;
+    expected_return_object &operator=(const expected_return_object &) = delete;
+    expected_return_object &operator=(expected_return_object &&) = delete;
+
+    ~expected_return_object() {
+        if (promise_) {
+            promise_->return_object_ = nullptr;
+        }
+    }
+
+    operator result_type() {
+        if (!promise_) {
+            return std::move(result_);
+        }
+        // The coroutine has not run yet, its result goes straight into the converted [expected]
+        expected_promise<ValueType, ErrorType> &promise = *std::exchange(promise_, nullptr);
+        promise.return_object_ = nullptr;
+        return result_type(result_slot_t{}, promise.result_);
+    }
+
+  private:
+    template <typename, typename>
+    friend class expected_promise;
+
+    void attach() noexcept {
+        promise_->result_ = std::addressof(result_);
+        promise_->return_object_ = this;
+    }
+
+    result_type result_;
+    expected_promise<ValueType, ErrorType> *promise_;
+};
+
+template <typename ValueType, typename ErrorType>
+class expected_promise {
+  public:
+    expected_promise() = default;
+
+    expected_promise(const expected_promise &) = delete;
+    expected_promise &operator=(const expected_promise &) = delete;
+
+    /// The coroutine ended, a return object converted afterwards holds the result
+    ~expected_promise() {
+        if (return_object_) {
+            return_object_->promise_ = nullptr;
+        }
+    }
+
+    expected_return_object<ValueType, ErrorType> get_return_object() noexcept {
+        return expected_return_object<ValueType, ErrorType>{*this};
+    }
+
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    /// Accepts anything [expected] can be assigned from: a value, an [unexpected] or an [expected]
+    template <typename U>
+    void return_value(U &&result) {
+        *result_ = std::forward<U>(result);
+    }
+
+    /// Errors travel as values, exceptions are left to propagate to the caller
+    void unhandled_exception() {
+        throw;
+    }
+
+    /// Called by a failed [co_await] of an [expected], makes [error] the result of the coroutine and
+    /// ends it, returning the coroutine to transfer to, which is none as this one ran in its caller
+    template <typename G>
+    std::coroutine_handle<> fail(G &&error) {
+        result_->emplace(unexpect, std::forward<G>(error));
+        std::coroutine_handle<expected_promise>::from_promise(*this).destroy();
+        return std::noop_coroutine();
+    }
+
+  private:
+    template <typename, typename>
+    friend class expected_return_object;
+
+    expected<ValueType, ErrorType> *result_ = nullptr;
+    expected_return_object<ValueType, ErrorType> *return_object_ = nullptr;
+};
+
+/// Awaiter for [ExpectedRef], a reference to an [expected], which only suspends when it holds an error
+///
+/// Any coroutine whose promise has [fail(error)], which ends the coroutine with that error and returns
+/// the coroutine to transfer to, can await an [expected] this way
+template <typename ExpectedRef>
+class expected_awaiter {
+    using ExpectedType = std::remove_cv_t<std::remove_reference_t<ExpectedRef>>;
+    using ValueType = typename ExpectedType::value_type;
+
+    /// Awaiting an rvalue returns the value by value, so it cannot dangle once the awaited temporary dies
+    using ResumeType = std::conditional_t<std::is_rvalue_reference_v<ExpectedRef &&>,
+                                          ValueType,
+                                          std::conditional_t<std::is_const_v<std::remove_reference_t<ExpectedRef>>,
+                                                             const ValueType &,
+                                                             ValueType &>>;
+
+  public:
+    explicit expected_awaiter(ExpectedRef &&awaited) noexcept : awaited_(std::forward<ExpectedRef>(awaited)) {}
+
+    bool await_ready() const noexcept {
+        return awaited_.has_value();
+    }
+
+    /// Short circuits the coroutine, the error becomes its result
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) {
+        return handle.promise().fail(std::forward<ExpectedRef>(awaited_).error());
+    }
+
+    ResumeType await_resume() {
+        return *std::forward<ExpectedRef>(awaited_);
+    }
+
+  private:
+    ExpectedRef &&awaited_;
+};
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+detail::expected_awaiter<expected<ValueType, ErrorType> &> operator co_await(expected<ValueType, ErrorType> &awaited) noexcept {
+    return detail::expected_awaiter<expected<ValueType, ErrorType> &>{awaited};
+}
+
+template <typename ValueType, typename ErrorType>
+detail::expected_awaiter<const expected<ValueType, ErrorType> &> operator co_await(const expected<ValueType, ErrorType> &awaited) noexcept {
+    return detail::expected_awaiter<const expected<ValueType, ErrorType> &>{awaited};
+}
+
+template <typename ValueType, typename ErrorType>
+detail::expected_awaiter<expected<ValueType, ErrorType>> operator co_await(expected<ValueType, ErrorType> &&awaited) noexcept {
+    return detail::expected_awaiter<expected<ValueType, ErrorType>>{std::move(awaited)};
+}
+
+} // namespace pstd
+
+template <typename ValueType, typename ErrorType, typename ... Args>
+struct std::coroutine_traits<pstd::expected<ValueType, ErrorType>, Args...> {
+    using promise_type = pstd::detail::expected_promise<ValueType, ErrorType>;
+};
+
+#endif
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "expected.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#if defined(__cpp_lib_atomic_wait)
+
+/// One shot channel of an [expected] result between threads
+///
+///     pstd::promise<Reply, Error> promise;
+///     pstd::future<Reply, Error> future = promise.get_future();
+///     std::thread([p = std::move(promise)]() mutable { p.set_value(call()); }).detach();
+///     const pstd::expected<Reply, Error> reply = future.get();
+///
+/// Unlike [std::promise] there is no [std::exception_ptr] and no mutex: the shared state is the result
+/// and a single 32 bit atomic word holding the ready flag, a waiter flag and the reference count, and
+/// [get] blocks with [std::atomic::wait], which is a futex wait on Linux, only when the result is not
+/// ready yet, setting the result only wakes the waiting thread if there is one
+///
+/// The shared state comes from [std::allocator] unless the promise is given another allocator, such as
+/// a [std::pmr::polymorphic_allocator] of a pool resource:
+///
+///     std::pmr::synchronized_pool_resource pool;
+///     pstd::promise<Reply, Error> promise(std::allocator_arg, std::pmr::polymorphic_allocator<>(&pool));
+///
+/// A promise destroyed without a result breaks it: the future becomes ready without a result, which
+/// [broken] reports, [get] then throws and [get(error)] returns the error the caller chose for it
+namespace pstd {
+
+namespace detail {
+
+class broken_promise : public std::exception {
+  public:
+    explicit broken_promise(const char* const error) : error_(error) {
+    }
+
+    virtual const char *what() const noexcept override {
+        return error_;
+    }
+
+  private:
+    const char* const error_;
+};
+
+template <typename ValueType, typename ErrorType>
+class shared_state {
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    static constexpr std::uint32_t kReady = 1U << 0;
+    static constexpr std::uint32_t kWaiting = 1U << 1;
+    /// Ready without a result
+    static constexpr std::uint32_t kBroken = 1U << 2;
+    static constexpr std::uint32_t kReference = 1U << 3;
+
+    shared_state(const shared_state &) = delete;
+    shared_state &operator=(const shared_state &) = delete;
+
+    void acquire() noexcept {
+        state_.fetch_add(kReference, std::memory_order_relaxed);
+    }
+
+    /// Frees the state with the last reference
+    void release() noexcept {
+        const std::uint32_t previous = state_.fetch_sub(kReference, std::memory_order_acq_rel);
+        if ((previous & ~(kReady | kWaiting | kBroken)) == kReference) {
+            if ((previous & kReady) && !(previous & kBroken)) {
+                std::destroy_at(std::addressof(result_));
+            }
+            destroy_(this);
+        }
+    }
+
+    /// Publishes the result, which must not be set yet
+    template <typename ... Args>
+    void set(Args && ... args) {
+        detail::construct_at(std::addressof(result_), std::forward<Args>(args)...);
+        publish(kReady);
+    }
+
+    /// Makes the state ready without a result
+    void break_promise() noexcept {
+        publish(kReady | kBroken);
+    }
+
+    bool is_broken() const noexcept {
+        return state_.load(std::memory_order_acquire) & kBroken;
+    }
+
+    bool is_ready() const noexcept {
+        return state_.load(std::memory_order_acquire) & kReady;
+    }
+
+    void wait() noexcept {
+        std::uint32_t state = state_.load(std::memory_order_acquire);
+        while (!(state & kReady)) {
+            if (!(state & kWaiting)) {
+                state = state_.fetch_or(kWaiting, std::memory_order_acquire) | kWaiting;
+                continue;
+            }
+            // Wakes up when any bit changes, including the reference count, so check again
+            state_.wait(state, std::memory_order_acquire);
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+
+    result_type &result() noexcept {
+        return result_;
+    }
+
+  protected:
+    using Destroy = void (*)(shared_state *) noexcept;
+
+    explicit shared_state(const Destroy destroy) noexcept : destroy_(destroy) {}
+
+    /// [result_] is destroyed in [release]
+    ~shared_state() {}
+
+  private:
+    void publish(const std::uint32_t bits) noexcept {
+        const std::uint32_t previous = state_.fetch_or(bits, std::memory_order_acq_rel);
+        if (previous & kWaiting) {
+            state_.notify_all();
+        }
+    }
+
+    std::atomic<std::uint32_t> state_{kReference};
+    const Destroy destroy_;
+    union {
+        result_type result_;
+    };
+};
+
+/// Shared state which frees itself with a copy of the allocator it came from
+template <typename ValueType, typename ErrorType, typename Allocator>
+class allocated_shared_state final : public shared_state<ValueType, ErrorType> {
+  private:
+    using Base = shared_state<ValueType, ErrorType>;
+    using AllocatorType = typename std::allocator_traits<Allocator>::template rebind_alloc<allocated_shared_state>;
+    using Traits = std::allocator_traits<AllocatorType>;
+
+  public:
+    static Base *create(const Allocator &allocator) {
+        AllocatorType rebound(allocator);
+        allocated_shared_state *state = Traits::allocate(rebound, 1);
+        ::new (static_cast<void *>(state)) allocated_shared_state(rebound);
+        return state;
+    }
+
+  private:
+    explicit allocated_shared_state(const AllocatorType &allocator) noexcept
+        : Base(&destroy), allocator_(allocator) {}
+
+    static void destroy(Base *base) noexcept {
+        auto *state = static_cast<allocated_shared_state *>(base);
+        AllocatorType allocator(std::move(state->allocator_));
+        state->~allocated_shared_state();
+        Traits::deallocate(allocator, state, 1);
+    }
+
+    AllocatorType allocator_;
+};
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+class promise;
+
+/// Receiving end of a [promise], move only
+template <typename ValueType, typename ErrorType>
+class future {
+  private:
+    using StateType = detail::shared_state<ValueType, ErrorType>;
+
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    future() noexcept = default;
+
+    future(future &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+    future &operator=(future &&other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+
+    future(const future &) = delete;
+    future &operator=(const future &) = delete;
+
+    ~future() {
+        reset();
+    }
+
+    /// Whether this refers to a shared state, false once [get] has been called
+    bool valid() const noexcept {
+        return state_ != nullptr;
+    }
+
+    bool is_ready() const noexcept {
+        return state_->is_ready();
+    }
+
+    /// Blocks until the result is set or the promise is destroyed
+    void wait() const noexcept {
+        state_->wait();
+    }
+
+    /// Waits for the result or for the promise to be destroyed, and returns whether it was destroyed
+    /// without a result
+    bool broken() const noexcept {
+        state_->wait();
+        return state_->is_broken();
+    }
+
+    /// Waits for the result and moves it out, releasing the shared state, throws [broken_promise] when
+    /// the promise was destroyed without a result, or aborts when exceptions are disabled
+    result_type get() {
+        state_->wait();
+        detail::throw_exception<detail::broken_promise>(state_->is_broken(), "Promise destroyed without a result");
+#ifdef PSTD_EXPECTED_DISABLE_EXCEPTIONS
+        // There is no result to move out and no exception to report it with
+        if (state_->is_broken()) {
+            std::abort();
+        }
+#endif
+        return take();
+    }
+
+    /// Same as [get], but returns [broken_error] when the promise was destroyed without a result
+    result_type get(ErrorType broken_error) {
+        state_->wait();
+        if (state_->is_broken()) {
+            reset();
+            return result_type(unexpected<ErrorType>(std::move(broken_error)));
+        }
+        return take();
+    }
+
+  private:
+    friend class promise<ValueType, ErrorType>;
+
+    explicit future(StateType *state) noexcept : state_(state) {}
+
+    result_type take() {
+        result_type result = std::move(state_->result());
+        reset();
+        return result;
+    }
+
+    void reset() noexcept {
+        if (state_) {
+            std::exchange(state_, nullptr)->release();
+        }
+    }
+
+    StateType *state_ = nullptr;
+};
+
+/// Sending end of a [future], move only
+template <typename ValueType, typename ErrorType>
+class promise {
+  private:
+    using StateType = detail::shared_state<ValueType, ErrorType>;
+
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    promise() : promise(std::allocator_arg, std::allocator<StateType>()) {}
+
+    /// Allocates the shared state with [allocator]
+    template <typename Allocator>
+    promise(std::allocator_arg_t, const Allocator &allocator)
+        : state_(detail::allocated_shared_state<ValueType, ErrorType, Allocator>::create(allocator)) {}
+
+    promise(promise &&other) noexcept
+        : state_(std::exchange(other.state_, nullptr)), has_result_(other.has_result_) {}
+
+    promise &operator=(promise &&other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::exchange(other.state_, nullptr);
+            has_result_ = other.has_result_;
+        }
+        return *this;
+    }
+
+    promise(const promise &) = delete;
+    promise &operator=(const promise &) = delete;
+
+    ~promise() {
+        reset();
+    }
+
+    /// Call once
+    future<ValueType, ErrorType> get_future() noexcept {
+        state_->acquire();
+        return future<ValueType, ErrorType>{state_};
+    }
+
+    /// Only the first result set is kept
+    void set_value(const ValueType &value) {
+        set(value);
+    }
+
+    void set_value(ValueType &&value) {
+        set(std::move(value));
+    }
+
+    void set_error(const ErrorType &error) {
+        set(unexpected<ErrorType>(error));
+    }
+
+    void set_error(ErrorType &&error) {
+        set(unexpected<ErrorType>(std::move(error)));
+    }
+
+    /// Sets the result to [result], which may be a value, an [unexpected] or an [expected]
+    template <typename U, std::enable_if_t<std::is_constructible_v<result_type, U>> * = nullptr>
+    void set_result(U &&result) {
+        set(std::forward<U>(result));
+    }
+
+  private:
+    template <typename ... Args>
+    void set(Args && ... args) {
+        if (!has_result_) {
+            state_->set(std::forward<Args>(args)...);
+            has_result_ = true;
+        }
+    }
+
+    void reset() noexcept {
+        if (state_) {
+            if (!has_result_) {
+                state_->break_promise();
+            }
+            std::exchange(state_, nullptr)->release();
+        }
+    }
+
+    StateType *state_ = nullptr;
+    bool has_result_ = false;
+};
+
+} // namespace pstd
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+/// Forward declarations of [expected], for headers which only name it in signatures
+///
+/// Deliberately includes nothing, the constraints on the template parameters are checked with
+/// static_asserts in expected.h, which must be included wherever the types are used
+namespace pstd {
+
+/// Tag to specify in place construction of the value
+struct in_place_t {};
+inline constexpr in_place_t in_place{};
+
+/// Tag to specify in place construction of the error
+struct unexpect_t {};
+inline constexpr unexpect_t unexpect{};
+
+template <typename ErrorType>
+class unexpected;
+
+template <typename ValueType, typename ErrorType>
+class expected;
+
+} // namespace pstd
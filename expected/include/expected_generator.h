@@ -0,0 +1,300 @@
+#pragma once
+
+#include "expected.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+
+/// Lazy sequence of [expected] results, produced one at a time as the consumer asks for them
+///
+///     pstd::generator<Record, Error> parse(std::istream &input) {
+///         for (std::string line; std::getline(input, line);) {
+///             co_yield parse_record(line);   // Yields either the record or the error
+///         }
+///     }
+///
+///     for (const Record &record : pstd::skip_errors(parse(input))) { ... }
+///
+/// The producer only runs while the consumer pulls, so a pipeline holds one result at a time and runs
+/// in constant memory however long the input is
+///
+/// [until_error] and [skip_errors] adapt any range of [expected] into a range of values
+namespace pstd {
+
+template <typename ValueType, typename ErrorType>
+class generator;
+
+namespace detail {
+
+template <typename ValueType, typename ErrorType>
+class generator_promise {
+  public:
+    using result_type = expected<ValueType, ErrorType>;
+
+    generator<ValueType, ErrorType> get_return_object() noexcept;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+
+    /// Temporaries live until the generator is resumed, so an rvalue result is yielded without a copy
+    std::suspend_always yield_value(result_type &&result) noexcept {
+        current_ = std::addressof(result);
+        return {};
+    }
+
+    /// Values, errors and lvalue results are copied into the promise first
+    template <typename U, std::enable_if_t<!std::is_same_v<std::decay_t<U>, result_type> ||
+                                           std::is_lvalue_reference_v<U>> * = nullptr>
+    std::suspend_always yield_value(U &&result) {
+        slot_ = std::forward<U>(result);
+        current_ = std::addressof(slot_);
+        return {};
+    }
+
+    void return_void() const noexcept {}
+
+    /// Stored and rethrown from the increment which resumed the generator
+    void unhandled_exception() noexcept {
+        exception_ = std::current_exception();
+    }
+
+    void rethrow_if_exception() {
+        if (exception_) {
+            std::rethrow_exception(std::exchange(exception_, nullptr));
+        }
+    }
+
+    result_type &current() const noexcept {
+        return *current_;
+    }
+
+  private:
+    result_type *current_ = nullptr;
+    result_type slot_;
+    std::exception_ptr exception_;
+};
+
+} // namespace detail
+
+/// Move only input range over the results yielded by a coroutine
+template <typename ValueType, typename ErrorType>
+class [[nodiscard]] generator {
+  public:
+    using promise_type = detail::generator_promise<ValueType, ErrorType>;
+    using result_type = expected<ValueType, ErrorType>;
+
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = result_type;
+        using reference = result_type &;
+        using pointer = result_type *;
+
+        iterator() noexcept = default;
+
+        explicit iterator(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        reference operator*() const noexcept {
+            return handle_.promise().current();
+        }
+
+        pointer operator->() const noexcept {
+            return std::addressof(handle_.promise().current());
+        }
+
+        iterator &operator++() {
+            handle_.resume();
+            handle_.promise().rethrow_if_exception();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept {
+            return it.handle_.done();
+        }
+
+      private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    explicit generator(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    generator(generator &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    generator &operator=(generator &&other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    generator(const generator &) = delete;
+    generator &operator=(const generator &) = delete;
+
+    ~generator() {
+        reset();
+    }
+
+    /// Runs the coroutine up to its first result, call once
+    iterator begin() {
+        handle_.resume();
+        handle_.promise().rethrow_if_exception();
+        return iterator{handle_};
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+  private:
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename ValueType, typename ErrorType>
+generator<ValueType, ErrorType> detail::generator_promise<ValueType, ErrorType>::get_return_object() noexcept {
+    return generator<ValueType, ErrorType>{std::coroutine_handle<generator_promise>::from_promise(*this)};
+}
+
+namespace detail {
+
+enum class error_policy {
+    stop,
+    skip,
+};
+
+/// Range over the values of a range of [expected], owns [Range] when constructed from an rvalue
+template <typename Range, error_policy Policy>
+class values_view {
+  private:
+    using RangeIterator = decltype(std::begin(std::declval<Range &>()));
+    using RangeSentinel = decltype(std::end(std::declval<Range &>()));
+    using ResultType = std::remove_reference_t<decltype(*std::declval<RangeIterator &>())>;
+    using ErrorType = typename std::remove_cv_t<ResultType>::error_type;
+
+  public:
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = decltype(**std::declval<RangeIterator &>());
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+
+        iterator() noexcept = default;
+
+        explicit iterator(values_view &view) : view_(&view) {
+            settle();
+        }
+
+        reference operator*() const {
+            return *view_->current();
+        }
+
+        iterator &operator++() {
+            ++*view_->it_;
+            settle();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator &it, std::default_sentinel_t) {
+            return it.done();
+        }
+
+      private:
+        bool done() const noexcept {
+            return view_->done_;
+        }
+
+        /// Moves past errors to the next value, or to the end
+        void settle() {
+            for (; !(*view_->it_ == *view_->end_); ++*view_->it_) {
+                if (view_->current().has_value()) {
+                    return;
+                }
+                view_->errors_++;
+                if constexpr (Policy == error_policy::stop) {
+                    view_->error_.emplace(view_->current().error());
+                    break;
+                }
+            }
+            view_->done_ = true;
+        }
+
+        values_view *view_ = nullptr;
+    };
+
+    template <typename R>
+    explicit values_view(R &&range) : range_(std::forward<R>(range)) {}
+
+    values_view(const values_view &) = delete;
+    values_view &operator=(const values_view &) = delete;
+
+    /// Starts iterating [range_], call once
+    iterator begin() {
+        it_.emplace(std::begin(range_));
+        end_.emplace(std::end(range_));
+        return iterator{*this};
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+    /// Number of errors seen so far
+    std::size_t errors() const noexcept {
+        return errors_;
+    }
+
+    /// The error which ended iteration, if any
+    const std::optional<ErrorType> &error() const noexcept {
+        return error_;
+    }
+
+  private:
+    ResultType &current() const {
+        return **it_;
+    }
+
+    Range range_;
+    std::optional<RangeIterator> it_;
+    std::optional<RangeSentinel> end_;
+    std::optional<ErrorType> error_;
+    std::size_t errors_ = 0;
+    bool done_ = false;
+};
+
+} // namespace detail
+
+/// Values of [range] up to its first error, which is kept in [error()] of the returned range
+template <typename Range>
+auto until_error(Range &&range) {
+    return detail::values_view<Range, detail::error_policy::stop>{std::forward<Range>(range)};
+}
+
+/// Values of [range], errors are dropped and counted in [errors()] of the returned range
+template <typename Range>
+auto skip_errors(Range &&range) {
+    return detail::values_view<Range, detail::error_policy::skip>{std::forward<Range>(range)};
+}
+
+} // namespace pstd
+
+#endif
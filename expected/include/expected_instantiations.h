@@ -0,0 +1,16 @@
+#pragma once
+
+#include "expected.h"
+
+#ifdef PSTD_EXPECTED_INSTANTIATIONS_LIST
+#include PSTD_EXPECTED_INSTANTIATIONS_LIST
+#else
+#include "expected_instantiations_list.h"
+#endif
+
+/// Suppresses implicit instantiation of the listed specializations in every translation unit that
+/// includes this header, their members are instead compiled once into expected_instantiations, which
+/// shrinks unoptimized objects but does not speed up builds, see expected_instantiations_list.h
+#define PSTD_EXPECTED_EXTERN_TEMPLATE(V, E) extern template class pstd::expected<V, E>;
+PSTD_EXPECTED_INSTANTIATIONS(PSTD_EXPECTED_EXTERN_TEMPLATE)
+#undef PSTD_EXPECTED_EXTERN_TEMPLATE
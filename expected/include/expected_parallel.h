@@ -0,0 +1,348 @@
+#pragma once
+
+#include "expected.h"
+#include "expected_algorithm.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Applies a function returning [expected] to every element of a range in parallel, giving either all
+/// the values or the error of the first failing element
+///
+///     pstd::expected<std::vector<Record>, Error> records = pstd::parallel_transform(ids, fetch);
+///
+/// The range is split into one contiguous chunk per worker, workers claim elements of their own chunk
+/// and steal elements from the chunks of other workers once theirs is done
+///
+/// Once an element fails, elements after it which have not started are skipped, elements before it
+/// still run, so the error is the one of the lowest failing index, as it would be sequentially
+///
+/// [partition_results] splits a range of [expected] into its values and its errors the same way
+namespace pstd {
+
+namespace detail {
+
+/// Size of a cache line, the unit of false sharing
+inline constexpr std::size_t kCacheLineSize = 64;
+
+} // namespace detail
+
+/// Fixed set of threads which run the same job together with the calling thread
+///
+/// Jobs are run one at a time, a job which starts another job on the same pool runs it on the calling
+/// thread, as the other workers are busy with the outer job
+class thread_pool {
+  public:
+    /// [threads] counts the calling thread, so a pool of 1 runs jobs on the calling thread only
+    explicit thread_pool(const std::size_t threads = std::thread::hardware_concurrency()) {
+        const std::size_t size = (threads == 0) ? (1) : (threads);
+        for (std::size_t worker = 1; worker < size; worker++) {
+            threads_.emplace_back([this, worker] { work(worker); });
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    /// Number of workers, including the calling thread
+    std::size_t size() const noexcept {
+        return threads_.size() + 1;
+    }
+
+    /// Calls [job(worker)] once on each worker, the calling thread being worker 0, and returns once all
+    /// calls return, rethrowing the first exception any of them threw
+    template <typename Job>
+    void run(Job &job) {
+        if (current() == this) {
+            for (std::size_t worker = 0; worker < size(); worker++) {
+                job(worker);
+            }
+            return;
+        }
+
+        void (*const invoke)(void *, std::size_t) = [](void *context, const std::size_t worker) {
+            (*static_cast<Job *>(context))(worker);
+        };
+        std::lock_guard<std::mutex> serialize(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            context_ = std::addressof(job);
+            invoke_ = invoke;
+            pending_ = threads_.size();
+            generation_++;
+        }
+        start_.notify_all();
+        run_worker(invoke, std::addressof(job), 0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    /// Pool with one worker per hardware thread, created on first use
+    static thread_pool &shared() {
+        static thread_pool pool;
+        return pool;
+    }
+
+  private:
+    void work(const std::size_t worker) {
+        std::size_t generation = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if (stop_) {
+                return;
+            }
+            generation = generation_;
+            void *const context = context_;
+            const auto invoke = invoke_;
+            lock.unlock();
+
+            run_worker(invoke, context, worker);
+
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    /// Calls [invoke(context, worker)] as a worker of this pool, keeping the first exception
+    void run_worker(void (*const invoke)(void *, std::size_t), void *const context, const std::size_t worker) noexcept {
+        thread_pool *const outer = std::exchange(current(), this);
+        try {
+            invoke(context, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        current() = outer;
+    }
+
+    /// Pool whose job the current thread is running
+    static thread_pool *&current() noexcept {
+        static thread_local thread_pool *pool = nullptr;
+        return pool;
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    void *context_ = nullptr;
+    void (*invoke_)(void *, std::size_t) = nullptr;
+    std::size_t pending_ = 0;
+    std::size_t generation_ = 0;
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+namespace detail {
+
+/// State of one worker, on its own cache line so that claiming elements and recording errors does not
+/// invalidate the lines of other workers
+template <typename ErrorType>
+struct alignas(kCacheLineSize) transform_slot {
+    /// Next unclaimed element of the chunk, other workers steal by claiming from it too
+    std::atomic<std::size_t> next{0};
+    std::size_t end = 0;
+    /// Lowest failing element this worker ran, and its error
+    std::size_t failed = static_cast<std::size_t>(-1);
+    ErrorType error{};
+};
+
+} // namespace detail
+
+/// Calls [f] on every element of the random access [range] on the workers of [pool], see above
+///
+/// An exception thrown by [f] stops the elements which have not started and is rethrown once the
+/// running ones finish, [f] may call [parallel_transform] or [partition_results] on [pool] itself,
+/// which then run on the calling worker
+template <typename Range, typename F>
+auto parallel_transform(thread_pool &pool, Range &&range, F &&f) {
+    using ResultType = std::decay_t<std::invoke_result_t<F &, decltype(*std::begin(range))>>;
+    static_assert(detail::is_expected<ResultType>::value, "[f] must return an expected");
+    using ValueType = typename ResultType::value_type;
+    using ErrorType = typename ResultType::error_type;
+    using SlotType = detail::transform_slot<ErrorType>;
+    static_assert(!std::is_same_v<ValueType, bool>, "std::vector<bool> cannot be written from several threads");
+
+    const auto first = std::begin(range);
+    const std::size_t count = static_cast<std::size_t>(std::distance(first, std::end(range)));
+    const std::size_t workers = pool.size();
+
+    std::vector<ValueType> values(count);
+    std::unique_ptr<SlotType[]> slots(new SlotType[workers]);
+    for (std::size_t worker = 0; worker < workers; worker++) {
+        slots[worker].next.store(count * worker / workers, std::memory_order_relaxed);
+        slots[worker].end = count * (worker + 1) / workers;
+    }
+    // Lowest failing index so far, read before each element to skip the ones after it
+    std::atomic<std::size_t> failed{count};
+    // An exception skips every element left, [thread_pool::run] rethrows it
+    auto invoke_or_cancel = [&](auto &function, auto &&element) -> ResultType {
+        try {
+            return std::invoke(function, std::forward<decltype(element)>(element));
+        } catch (...) {
+            failed.store(0, std::memory_order_relaxed);
+            throw;
+        }
+    };
+
+    auto job = [&](const std::size_t worker) {
+        SlotType &own = slots[worker];
+        for (std::size_t offset = 0; offset < workers; offset++) {
+            SlotType &chunk = slots[(worker + offset) % workers];
+            for (std::size_t i = chunk.next.fetch_add(1, std::memory_order_relaxed); i < chunk.end;
+                 i = chunk.next.fetch_add(1, std::memory_order_relaxed)) {
+                // Chunks are claimed in order, so the rest of this chunk is after the failure too
+                if (i > failed.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                ResultType result = invoke_or_cancel(f, *(first + static_cast<std::ptrdiff_t>(i)));
+                if (result.has_value()) {
+                    values[i] = std::move(*result);
+                    continue;
+                }
+                if (i < own.failed) {
+                    own.failed = i;
+                    own.error = std::move(result).error();
+                }
+                std::size_t lowest = failed.load(std::memory_order_relaxed);
+                while (i < lowest && !failed.compare_exchange_weak(lowest, i, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    };
+    pool.run(job);
+
+    SlotType *lowest = nullptr;
+    for (std::size_t worker = 0; worker < workers; worker++) {
+        if (slots[worker].failed < count && (!lowest || slots[worker].failed < lowest->failed)) {
+            lowest = &slots[worker];
+        }
+    }
+    if (lowest) {
+        return expected<std::vector<ValueType>, ErrorType>(unexpected<ErrorType>(std::move(lowest->error)));
+    }
+    return expected<std::vector<ValueType>, ErrorType>(std::move(values));
+}
+
+/// Calls [f] on every element of the random access [range] on [thread_pool::shared()], nested calls
+/// from [f] run on the calling worker
+template <typename Range, typename F>
+auto parallel_transform(Range &&range, F &&f) {
+    return parallel_transform(thread_pool::shared(), std::forward<Range>(range), std::forward<F>(f));
+}
+
+/// The values and the errors of a range of [expected], each in their original order
+template <typename ValueType, typename ErrorType>
+struct partitioned_results {
+    std::vector<ValueType> values;
+    std::vector<ErrorType> errors;
+};
+
+namespace detail {
+
+/// Number of values and errors in the block of one worker
+struct alignas(kCacheLineSize) partition_slot {
+    std::size_t values = 0;
+    std::size_t errors = 0;
+};
+
+} // namespace detail
+
+/// Splits the random access [range] into its values and its errors on the workers of [pool]
+///
+///     auto [records, failures] = pstd::partition_results(pool, std::move(results));
+///
+/// Each worker counts the values and errors of its own contiguous block, a prefix sum of the counts
+/// gives every block the offsets where its values and errors go, then each worker moves its block
+/// there, and nothing is shared between workers but the counts
+///
+/// The output vectors are value initialized up front so that workers can fill them in place, so each
+/// element costs a value initialization, which is a memset for trivial types, and one move assignment,
+/// or copy assignment when [range] is an lvalue
+template <typename Range>
+auto partition_results(thread_pool &pool, Range &&range) {
+    using ExpectedType = detail::range_expected_t<Range>;
+    using ValueType = typename ExpectedType::value_type;
+    using ErrorType = typename ExpectedType::error_type;
+    static_assert(!std::is_same_v<ValueType, bool> && !std::is_same_v<ErrorType, bool>,
+                  "std::vector<bool> cannot be written from several threads");
+
+    const auto first = std::begin(range);
+    const std::size_t count = static_cast<std::size_t>(std::distance(first, std::end(range)));
+    const std::size_t workers = pool.size();
+    std::unique_ptr<detail::partition_slot[]> slots(new detail::partition_slot[workers]);
+
+    auto count_block = [&](const std::size_t worker) {
+        std::size_t values = 0;
+        for (std::size_t i = count * worker / workers; i < count * (worker + 1) / workers; i++) {
+            values += static_cast<std::size_t>((first + static_cast<std::ptrdiff_t>(i))->has_value());
+        }
+        slots[worker].values = values;
+        slots[worker].errors = count * (worker + 1) / workers - count * worker / workers - values;
+    };
+    pool.run(count_block);
+
+    // Exclusive prefix sums, turning the counts of each block into its offsets
+    std::size_t values = 0;
+    std::size_t errors = 0;
+    for (std::size_t worker = 0; worker < workers; worker++) {
+        const detail::partition_slot block = slots[worker];
+        slots[worker] = detail::partition_slot{values, errors};
+        values += block.values;
+        errors += block.errors;
+    }
+
+    partitioned_results<ValueType, ErrorType> result{std::vector<ValueType>(values), std::vector<ErrorType>(errors)};
+    auto move_block = [&](const std::size_t worker) {
+        std::size_t value = slots[worker].values;
+        std::size_t error = slots[worker].errors;
+        for (std::size_t i = count * worker / workers; i < count * (worker + 1) / workers; i++) {
+            auto &element = *(first + static_cast<std::ptrdiff_t>(i));
+            if (element.has_value()) {
+                result.values[value++] = *detail::forward_element<Range>(element);
+            } else {
+                result.errors[error++] = detail::forward_element<Range>(element).error();
+            }
+        }
+    };
+    pool.run(move_block);
+    return result;
+}
+
+/// Splits the random access [range] into its values and its errors on [thread_pool::shared()], or on
+/// the calling worker when called from a job of that pool
+template <typename Range>
+auto partition_results(Range &&range) {
+    return partition_results(thread_pool::shared(), std::forward<Range>(range));
+}
+
+} // namespace pstd
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "expected_vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/// Run-length compressed states of a sequence of [expected], for sequences where errors are rare
+///
+///     pstd::state_runs runs = pstd::state_runs::from_bitmap(results.bitmap(), results.size());
+///     runs.for_each_error([&](std::size_t index) { retry(index, results.errors()[index]); });
+///
+/// Only the runs of errors are stored, as the index of their first element and their length, so a
+/// sequence of a million successes and a few errors takes a few runs instead of 16 KiB of bitmap, and
+/// visiting the errors costs O(runs) instead of O(size / 64)
+///
+/// Dense or scattered errors are better kept as a bitmap, at worst every other element fails and each
+/// error takes a run of its own
+namespace pstd {
+
+class state_runs {
+  public:
+    /// Run of consecutive errors
+    struct run {
+        std::size_t begin = 0;
+        std::size_t length = 0;
+    };
+
+    state_runs() = default;
+
+    /// Runs of the first [size] elements of an LSB first bitmap such as [expected_vector::bitmap()],
+    /// skipping whole words of successes
+    static state_runs from_bitmap(const std::uint64_t *bitmap, const std::size_t size) {
+        constexpr std::size_t kWordBits = 64;
+        state_runs runs;
+        for (std::size_t base = 0; base < size; base += kWordBits) {
+            std::uint64_t errors = ~bitmap[base / kWordBits];
+            if (size - base < kWordBits) {
+                errors &= (std::uint64_t{1} << (size - base)) - 1;
+            }
+            while (errors != 0) {
+                const std::size_t first = static_cast<std::size_t>(detail::countr_zero64(errors));
+                // Bits from [first] up to the next success, all of the rest of the word when there is none
+                const std::uint64_t from_first = errors >> first;
+                const std::size_t length = (~from_first == 0) ? (kWordBits - first) :
+                                           static_cast<std::size_t>(detail::countr_zero64(~from_first));
+                runs.add(base + first, length);
+                errors = (first + length == kWordBits) ? (0) : (errors & (~std::uint64_t{0} << (first + length)));
+            }
+        }
+        runs.size_ = size;
+        return runs;
+    }
+
+    template <typename ValueType, typename ErrorType>
+    static state_runs from_vector(const expected_vector<ValueType, ErrorType> &vector) {
+        return from_bitmap(vector.bitmap(), vector.size());
+    }
+
+    /// Appends the state of one element, extending the last run when it is an error following one
+    void push_back(const bool has_value) {
+        if (!has_value) {
+            add(size_, 1);
+        }
+        size_++;
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// Whether element [index] has a value, in O(log(runs))
+    bool has_value(const std::size_t index) const noexcept {
+        const auto after = std::upper_bound(runs_.begin(), runs_.end(), index,
+                                            [](const std::size_t i, const run &r) { return i < r.begin; });
+        return after == runs_.begin() || index >= std::prev(after)->begin + std::prev(after)->length;
+    }
+
+    std::size_t count_errors() const noexcept {
+        std::size_t count = 0;
+        for (const run &r : runs_) {
+            count += r.length;
+        }
+        return count;
+    }
+
+    std::size_t count_values() const noexcept {
+        return size_ - count_errors();
+    }
+
+    /// The runs of errors, in order, neither empty nor adjacent
+    const std::vector<run> &runs() const noexcept {
+        return runs_;
+    }
+
+    /// Calls [f(index)] for each element which has an error, in order, never visiting the successes
+    template <typename F>
+    void for_each_error(F &&f) const {
+        for (const run &r : runs_) {
+            for (std::size_t i = r.begin; i < r.begin + r.length; i++) {
+                f(i);
+            }
+        }
+    }
+
+  private:
+    void add(const std::size_t begin, const std::size_t length) {
+        if (!runs_.empty() && runs_.back().begin + runs_.back().length == begin) {
+            runs_.back().length += length;
+        } else {
+            runs_.push_back(run{begin, length});
+        }
+    }
+
+    std::vector<run> runs_;
+    std::size_t size_ = 0;
+};
+
+} // namespace pstd
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "expected.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PSTD_EXPECTED_SCAN_X86
+#endif
+
+#if defined(__cpp_lib_span)
+
+/// Kernels scanning spans of [expected] by their state bytes
+///
+///     std::span<const pstd::expected<double, Error>> samples = ...;
+///     const std::size_t failed = pstd::scan::count_errors(samples);
+///     const std::size_t first = pstd::scan::find_first_error(samples);   // samples.size() if none
+///     const std::size_t written = pstd::scan::gather_values(samples, out);
+///
+/// The [has_value_] byte of element [i] is at a fixed stride from the one of element [0], so when the
+/// stride divides the vector width one load covers several elements, and a compare, a move mask and
+/// a mask of the state positions give the states of all of them
+///
+/// The AVX2 (32 bytes, strides up to 32) or SSE4.2 (16 bytes, strides up to 16) kernels are picked at
+/// runtime with CPUID, other strides and other processors use the scalar kernels
+namespace pstd {
+
+namespace detail {
+
+/// Same size and alignment as the union of the alternatives in [expected_storage], which the state
+/// byte follows
+template <typename ValueType, typename ErrorType>
+union expected_payload_layout {
+    alignas(ValueType) unsigned char value[sizeof(ValueType)];
+    alignas(unexpected<ErrorType>) unsigned char error[sizeof(unexpected<ErrorType>)];
+};
+
+/// Offset of the state byte in [expected<ValueType, ErrorType>], which is 1 with a value and 0 with
+/// an error
+template <typename ValueType, typename ErrorType>
+inline constexpr std::size_t state_offset_v = sizeof(expected_payload_layout<ValueType, ErrorType>);
+
+/// Functions scanning [count] state bytes [stride] bytes apart starting at [states]
+struct scan_kernels {
+    std::size_t (*count_errors)(const unsigned char *states, std::size_t count, std::size_t stride);
+    std::size_t (*find_first_error)(const unsigned char *states, std::size_t count, std::size_t stride);
+    /// Writes the indices of the elements which have a value to [indices], returns how many
+    std::size_t (*value_indices)(const unsigned char *states, std::size_t count, std::size_t stride,
+                                 std::uint32_t *indices);
+};
+
+inline std::size_t scalar_count_errors(const unsigned char *states, const std::size_t count,
+                                       const std::size_t stride) {
+    std::size_t errors = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        errors += (states[i * stride] == 0);
+    }
+    return errors;
+}
+
+inline std::size_t scalar_find_first_error(const unsigned char *states, const std::size_t count,
+                                           const std::size_t stride) {
+    for (std::size_t i = 0; i < count; i++) {
+        if (states[i * stride] == 0) {
+            return i;
+        }
+    }
+    return count;
+}
+
+inline std::size_t scalar_value_indices(const unsigned char *states, const std::size_t count,
+                                        const std::size_t stride, std::uint32_t *indices) {
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        indices[written] = static_cast<std::uint32_t>(i);
+        written += (states[i * stride] != 0);
+    }
+    return written;
+}
+
+inline constexpr scan_kernels kScalarKernels = {
+    scalar_count_errors,
+    scalar_find_first_error,
+    scalar_value_indices,
+};
+
+/// Bits of a [Width] bit move mask which are at state bytes, 0 when [stride] does not divide [Width]
+template <std::size_t Width>
+constexpr std::uint32_t state_pattern(const std::size_t stride) noexcept {
+    if (stride == 0 || stride > Width || Width % stride != 0) {
+        return 0;
+    }
+    std::uint32_t pattern = 0;
+    for (std::size_t bit = 0; bit < Width; bit += stride) {
+        pattern |= std::uint32_t{1} << bit;
+    }
+    return pattern;
+}
+
+#if defined(PSTD_EXPECTED_SCAN_X86)
+
+/// Defines the kernels of one instruction set, [LOAD_ERRORS(p)] gives the move mask of the zero bytes
+/// of the [WIDTH] bytes at [p]
+///
+/// A block of elements is only loaded when the element after it exists, so a load never reads past
+/// the last element
+#define PSTD_EXPECTED_SCAN_KERNELS(NAME, TARGET, WIDTH, LOAD_ERRORS)                                       \
+    __attribute__((target(TARGET))) inline std::size_t NAME##_count_errors(                                \
+        const unsigned char *states, const std::size_t count, const std::size_t stride) {                  \
+        const std::uint32_t pattern = state_pattern<WIDTH>(stride);                                        \
+        if (pattern == 0) {                                                                                \
+            return scalar_count_errors(states, count, stride);                                             \
+        }                                                                                                  \
+        const std::size_t per_block = WIDTH / stride;                                                      \
+        std::size_t errors = 0;                                                                            \
+        std::size_t i = 0;                                                                                 \
+        for (; i + per_block < count; i += per_block) {                                                    \
+            errors += static_cast<std::size_t>(_mm_popcnt_u32(LOAD_ERRORS(states + i * stride) & pattern)); \
+        }                                                                                                  \
+        return errors + scalar_count_errors(states + i * stride, count - i, stride);                       \
+    }                                                                                                      \
+                                                                                                           \
+    __attribute__((target(TARGET))) inline std::size_t NAME##_find_first_error(                            \
+        const unsigned char *states, const std::size_t count, const std::size_t stride) {                  \
+        const std::uint32_t pattern = state_pattern<WIDTH>(stride);                                        \
+        if (pattern == 0) {                                                                                \
+            return scalar_find_first_error(states, count, stride);                                         \
+        }                                                                                                  \
+        const std::size_t per_block = WIDTH / stride;                                                      \
+        std::size_t i = 0;                                                                                 \
+        for (; i + per_block < count; i += per_block) {                                                    \
+            const std::uint32_t errors = LOAD_ERRORS(states + i * stride) & pattern;                       \
+            if (errors != 0) {                                                                             \
+                return i + static_cast<std::size_t>(__builtin_ctz(errors)) / stride;                       \
+            }                                                                                              \
+        }                                                                                                  \
+        return i + scalar_find_first_error(states + i * stride, count - i, stride);                        \
+    }                                                                                                      \
+                                                                                                           \
+    __attribute__((target(TARGET))) inline std::size_t NAME##_value_indices(                               \
+        const unsigned char *states, const std::size_t count, const std::size_t stride,                    \
+        std::uint32_t *indices) {                                                                          \
+        const std::uint32_t pattern = state_pattern<WIDTH>(stride);                                        \
+        if (pattern == 0) {                                                                                \
+            return scalar_value_indices(states, count, stride, indices);                                   \
+        }                                                                                                  \
+        const std::size_t per_block = WIDTH / stride;                                                      \
+        std::size_t written = 0;                                                                           \
+        std::size_t i = 0;                                                                                 \
+        for (; i + per_block < count; i += per_block) {                                                    \
+            std::uint32_t values = ~LOAD_ERRORS(states + i * stride) & pattern;                            \
+            if (values == pattern) {                                                                       \
+                for (std::size_t j = 0; j < per_block; j++) {                                              \
+                    indices[written++] = static_cast<std::uint32_t>(i + j);                                \
+                }                                                                                          \
+                continue;                                                                                  \
+            }                                                                                              \
+            for (; values != 0; values &= values - 1) {                                                    \
+                indices[written++] = static_cast<std::uint32_t>(                                           \
+                    i + static_cast<std::size_t>(__builtin_ctz(values)) / stride);                         \
+            }                                                                                              \
+        }                                                                                                  \
+        const std::size_t tail = scalar_value_indices(states + i * stride, count - i, stride,              \
+                                                      indices + written);                                  \
+        for (std::size_t j = written; j < written + tail; j++) {                                           \
+            indices[j] += static_cast<std::uint32_t>(i);                                                   \
+        }                                                                                                  \
+        return written + tail;                                                                             \
+    }                                                                                                      \
+                                                                                                           \
+    inline constexpr scan_kernels k##NAME##Kernels = {                                                     \
+        NAME##_count_errors,                                                                               \
+        NAME##_find_first_error,                                                                           \
+        NAME##_value_indices,                                                                              \
+    };
+
+#define PSTD_EXPECTED_SCAN_AVX2_ERRORS(p)                                                                  \
+    static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(                                     \
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), _mm256_setzero_si256())))
+
+#define PSTD_EXPECTED_SCAN_SSE42_ERRORS(p)                                                                 \
+    static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(                                           \
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_setzero_si128())))
+
+PSTD_EXPECTED_SCAN_KERNELS(Avx2, "avx2,popcnt", 32, PSTD_EXPECTED_SCAN_AVX2_ERRORS)
+PSTD_EXPECTED_SCAN_KERNELS(Sse42, "sse4.2,popcnt", 16, PSTD_EXPECTED_SCAN_SSE42_ERRORS)
+
+#undef PSTD_EXPECTED_SCAN_KERNELS
+#undef PSTD_EXPECTED_SCAN_AVX2_ERRORS
+#undef PSTD_EXPECTED_SCAN_SSE42_ERRORS
+
+#endif
+
+} // namespace detail
+
+namespace scan {
+
+enum class instruction_set {
+    scalar,
+    sse42,
+    avx2,
+};
+
+/// Whether the processor running this can use [set]
+inline bool is_supported(const instruction_set set) noexcept {
+    switch (set) {
+#if defined(PSTD_EXPECTED_SCAN_X86)
+        case instruction_set::avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        case instruction_set::sse42:
+            return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+#endif
+        case instruction_set::scalar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/// Widest instruction set the processor supports, checked once
+inline instruction_set best_instruction_set() noexcept {
+    static const instruction_set best = (is_supported(instruction_set::avx2))  ? (instruction_set::avx2) :
+                                        (is_supported(instruction_set::sse42)) ? (instruction_set::sse42) :
+                                                                                 (instruction_set::scalar);
+    return best;
+}
+
+} // namespace scan
+
+namespace detail {
+
+inline const scan_kernels &kernels_for(const scan::instruction_set set) noexcept {
+    switch (set) {
+#if defined(PSTD_EXPECTED_SCAN_X86)
+        case scan::instruction_set::avx2:
+            return kAvx2Kernels;
+        case scan::instruction_set::sse42:
+            return kSse42Kernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+template <typename ValueType, typename ErrorType>
+const unsigned char *states_of(const std::span<const expected<ValueType, ErrorType>> results) noexcept {
+    static_assert(sizeof(expected<ValueType, ErrorType>) > state_offset_v<ValueType, ErrorType>,
+                  "the state byte follows the payload");
+    return reinterpret_cast<const unsigned char *>(results.data()) + state_offset_v<ValueType, ErrorType>;
+}
+
+} // namespace detail
+
+namespace scan {
+
+/// Number of [results] which have an error
+template <typename ValueType, typename ErrorType>
+std::size_t count_errors(const std::span<const expected<ValueType, ErrorType>> results,
+                         const instruction_set set = best_instruction_set()) noexcept {
+    return detail::kernels_for(set).count_errors(detail::states_of(results), results.size(),
+                                                  sizeof(expected<ValueType, ErrorType>));
+}
+
+/// Index of the first of [results] which has an error, [results.size()] if none has
+template <typename ValueType, typename ErrorType>
+std::size_t find_first_error(const std::span<const expected<ValueType, ErrorType>> results,
+                             const instruction_set set = best_instruction_set()) noexcept {
+    return detail::kernels_for(set).find_first_error(detail::states_of(results), results.size(),
+                                                      sizeof(expected<ValueType, ErrorType>));
+}
+
+/// Copies the values of [results] to the front of [out], returns how many were copied
+///
+/// Throws [std::length_error] when [results] has more values than fit in [out], after copying those
+/// which fit, as [collect] into a span does
+template <typename ValueType, typename ErrorType>
+std::size_t gather_values(const std::span<const expected<ValueType, ErrorType>> results, const std::span<ValueType> out,
+                          const instruction_set set = best_instruction_set()) {
+    constexpr std::size_t kChunk = 256;
+    constexpr std::size_t kStride = sizeof(expected<ValueType, ErrorType>);
+    const detail::scan_kernels &kernels = detail::kernels_for(set);
+    const unsigned char *const states = detail::states_of(results);
+    const expected<ValueType, ErrorType> *const data = results.data();
+    ValueType *const destination = out.data();
+    std::uint32_t indices[kChunk];
+    std::size_t written = 0;
+    std::size_t values = 0;
+    for (std::size_t first = 0; first < results.size(); first += kChunk) {
+        const std::size_t count = (results.size() - first < kChunk) ? (results.size() - first) : (kChunk);
+        const std::size_t found = kernels.value_indices(states + first * kStride, count, kStride, indices);
+        values += found;
+        // Only the values which still fit are copied
+        const std::size_t fit = (out.size() - written < found) ? (out.size() - written) : (found);
+        if (found == count) {
+            // No error in the chunk, copy it without the indices
+            for (std::size_t j = 0; j < fit; j++) {
+                destination[written + j] = *data[first + j];
+            }
+        } else {
+            for (std::size_t j = 0; j < fit; j++) {
+                destination[written + j] = *data[first + indices[j]];
+            }
+        }
+        written += fit;
+    }
+    detail::throw_exception<std::length_error>(values > written, "More values than fit in the output span");
+    return written;
+}
+
+} // namespace scan
+
+} // namespace pstd
+
+#endif
@@ -0,0 +1,467 @@
+#pragma once
+
+#include "expected_coroutine.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/// Lazy coroutine whose result is an [expected], so errors flow as values and resuming never unwinds
+///
+///     pstd::task<Reply, Error> handle(Request request) {
+///         const Session session = co_await co_await open_session(request);   // Fails the task on error
+///         co_return co_await reply(session);                                   // Forwards the result
+///     }
+///
+/// [co_await] on a [task] starts it and yields its [expected], a further [co_await] on that [expected]
+/// ends the awaiting task with the error, as it does in coroutines returning [expected]
+///
+/// Starting a task and resuming the awaiting coroutine once it completes go through a [trampoline]
+/// which resumes one coroutine after another in a loop, so arbitrarily deep chains of tasks which
+/// complete synchronously run in constant stack space at any optimization level, without relying on
+/// the compiler turning symmetric transfer into tail calls
+namespace pstd {
+
+template <typename ValueType, typename ErrorType>
+class task;
+
+namespace detail {
+
+/// Loop resuming coroutines on the current thread, coroutines hand it the next coroutine to run and
+/// return to it instead of resuming that coroutine from their own stack frame
+class trampoline {
+  public:
+    trampoline(const trampoline &) = delete;
+    trampoline &operator=(const trampoline &) = delete;
+
+    /// Runs [next] after the current coroutine suspends, on the loop of this thread or on a new one when
+    /// this thread has none, or when a coroutine resumed outside the loop already handed it one
+    static void transfer(const std::coroutine_handle<> next) {
+        trampoline *const active = current();
+        if (active && !active->next_) {
+            active->next_ = next;
+            return;
+        }
+        run(next);
+    }
+
+    /// Resumes [first] and every coroutine it transfers to on a new loop, returns once none is left
+    static void run(const std::coroutine_handle<> first) {
+        trampoline loop(first);
+        while (loop.next_) {
+            std::exchange(loop.next_, nullptr).resume();
+        }
+    }
+
+  private:
+    explicit trampoline(const std::coroutine_handle<> first) noexcept
+        : next_(first), outer_(std::exchange(current(), this)) {}
+
+    ~trampoline() {
+        current() = outer_;
+    }
+
+    static trampoline *&current() noexcept {
+        static thread_local trampoline *active = nullptr;
+        return active;
+    }
+
+    std::coroutine_handle<> next_;
+    trampoline *const outer_;
+};
+
+template <typename ValueType, typename ErrorType>
+class task_promise {
+  public:
+    task<ValueType, ErrorType> get_return_object() noexcept;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    /// Transfers to whichever coroutine awaited this one
+    struct final_awaiter {
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<task_promise> handle) noexcept {
+            trampoline::transfer(handle.promise().continuation_);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    final_awaiter final_suspend() const noexcept { return {}; }
+
+    /// Accepts anything [expected] can be assigned from: a value, an [unexpected] or an [expected]
+    template <typename U>
+    void return_value(U &&result) {
+        result_ = std::forward<U>(result);
+    }
+
+    /// Errors travel as values, exceptions propagate out of whichever call resumed the task
+    void unhandled_exception() {
+        throw;
+    }
+
+    /// Called by a failed [co_await] of an [expected], makes [error] the result and transfers to
+    /// the awaiting coroutine, the suspended frame is destroyed with its [task]
+    template <typename G>
+    std::coroutine_handle<> fail(G &&error) {
+        result_.emplace(unexpect, std::forward<G>(error));
+        trampoline::transfer(continuation_);
+        return std::noop_coroutine();
+    }
+
+    void set_continuation(const std::coroutine_handle<> continuation) noexcept {
+        continuation_ = continuation;
+    }
+
+    expected<ValueType, ErrorType> &result() noexcept {
+        return result_;
+    }
+
+  private:
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+    expected<ValueType, ErrorType> result_;
+};
+
+/// Signalled when [sync_wait] finishes, possibly from another thread
+///
+/// The waiter returns and destroys the event as soon as it sees it set, so [set] notifies under the
+/// mutex the waiter takes, never touching the event once the waiter can observe it
+class sync_wait_event {
+  public:
+    void set() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        condition_.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return done_; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool done_ = false;
+};
+
+/// Eager coroutine which drives a [task] from a thread that is not a coroutine
+class sync_wait_driver {
+  public:
+    struct promise_type {
+        sync_wait_event *event_ = nullptr;
+
+        sync_wait_driver get_return_object() noexcept {
+            return sync_wait_driver{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                handle.promise().event_->set();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        final_awaiter final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() {
+            throw;
+        }
+    };
+
+    explicit sync_wait_driver(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    sync_wait_driver(const sync_wait_driver &) = delete;
+    sync_wait_driver &operator=(const sync_wait_driver &) = delete;
+
+    ~sync_wait_driver() {
+        handle_.destroy();
+    }
+
+    void run(sync_wait_event &event) {
+        handle_.promise().event_ = &event;
+        trampoline::run(handle_);
+        event.wait();
+    }
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename ValueType, typename ErrorType>
+sync_wait_driver make_sync_wait_driver(task<ValueType, ErrorType> &&work, expected<ValueType, ErrorType> &result) {
+    result = co_await std::move(work);
+}
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+class [[nodiscard]] task {
+  public:
+    using promise_type = detail::task_promise<ValueType, ErrorType>;
+    using result_type = expected<ValueType, ErrorType>;
+
+    explicit task(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    task &operator=(task &&other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task() {
+        reset();
+    }
+
+    /// Starts the task, resuming the awaiting coroutine with the [expected] result once it completes
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle_;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(const std::coroutine_handle<> continuation) {
+                handle_.promise().set_continuation(continuation);
+                detail::trampoline::transfer(handle_);
+            }
+
+            result_type await_resume() {
+                return std::move(handle_.promise().result());
+            }
+        };
+
+        return awaiter{handle_};
+    }
+
+  private:
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename ValueType, typename ErrorType>
+task<ValueType, ErrorType> detail::task_promise<ValueType, ErrorType>::get_return_object() noexcept {
+    return task<ValueType, ErrorType>{std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+/// Runs [work] to completion, blocking the calling thread until it completes on whichever thread
+template <typename ValueType, typename ErrorType>
+expected<ValueType, ErrorType> sync_wait(task<ValueType, ErrorType> work) {
+    expected<ValueType, ErrorType> result;
+    detail::sync_wait_event event;
+    auto driver = detail::make_sync_wait_driver(std::move(work), result);
+    driver.run(event);
+    return result;
+}
+
+namespace detail {
+
+/// Counts the children of a [when_all] still running, the last one to complete resumes the awaiting
+/// coroutine, the awaiting coroutine holds one count itself until it has started every child
+class when_all_latch {
+  public:
+    explicit when_all_latch(const std::size_t children) noexcept : pending_(children + 1) {}
+
+    /// Returns whether this was the last count
+    bool arrive() noexcept {
+        return pending_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    void fail() noexcept {
+        failed_.store(true, std::memory_order_relaxed);
+    }
+
+    bool failed() const noexcept {
+        return failed_.load(std::memory_order_relaxed);
+    }
+
+    std::coroutine_handle<> continuation_;
+
+  private:
+    std::atomic<std::size_t> pending_;
+    std::atomic<bool> failed_{false};
+};
+
+/// Lazy coroutine awaiting one child of a [when_all] and counting it down on the latch once done
+class when_all_child {
+  public:
+    struct promise_type {
+        when_all_latch *latch_ = nullptr;
+
+        when_all_child get_return_object() noexcept {
+            return when_all_child{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                when_all_latch &latch = *handle.promise().latch_;
+                if (latch.arrive()) {
+                    trampoline::transfer(latch.continuation_);
+                }
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        final_awaiter final_suspend() const noexcept { return {}; }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() {
+            throw;
+        }
+    };
+
+    explicit when_all_child(const std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    when_all_child(when_all_child &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    when_all_child(const when_all_child &) = delete;
+    when_all_child &operator=(const when_all_child &) = delete;
+
+    ~when_all_child() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /// Runs the child until it completes or suspends
+    void start(when_all_latch &latch) {
+        handle_.promise().latch_ = &latch;
+        trampoline::run(handle_);
+    }
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename ValueType, typename ErrorType>
+when_all_child make_when_all_child(task<ValueType, ErrorType> work, expected<ValueType, ErrorType> &result,
+                                   when_all_latch &latch) {
+    result = co_await std::move(work);
+    if (!result.has_value()) {
+        latch.fail();
+    }
+}
+
+/// Starts every child, stopping at the first error of a child which completed synchronously, and
+/// resumes the awaiting coroutine once every started child completed
+class when_all_awaiter {
+  public:
+    when_all_awaiter(when_all_child *children, const std::size_t size, when_all_latch &latch) noexcept
+        : children_(children), size_(size), latch_(latch) {}
+
+    bool await_ready() const noexcept {
+        return size_ == 0;
+    }
+
+    bool await_suspend(const std::coroutine_handle<> continuation) {
+        latch_.continuation_ = continuation;
+        for (std::size_t i = 0; i < size_; i++) {
+            if (latch_.failed()) {
+                // Never started, so it is counted down here
+                latch_.arrive();
+            } else {
+                children_[i].start(latch_);
+            }
+        }
+        // The awaiting coroutine may be resumed by the last child as soon as its count is released
+        return !latch_.arrive();
+    }
+
+    void await_resume() const noexcept {}
+
+  private:
+    when_all_child *children_;
+    std::size_t size_;
+    when_all_latch &latch_;
+};
+
+template <typename ErrorType, typename ... ValueTypes, std::size_t ... Indices>
+task<std::tuple<ValueTypes...>, ErrorType> when_all(std::index_sequence<Indices...>,
+                                                    task<ValueTypes, ErrorType> ... tasks) {
+    std::tuple<expected<ValueTypes, ErrorType>...> results;
+    when_all_latch latch(sizeof...(ValueTypes));
+    std::array<when_all_child, sizeof...(ValueTypes)> children = {
+        make_when_all_child(std::move(tasks), std::get<Indices>(results), latch)...
+    };
+    co_await when_all_awaiter(children.data(), children.size(), latch);
+
+    if (latch.failed()) {
+        const ErrorType *error = nullptr;
+        static_cast<void>(((!std::get<Indices>(results).has_value() && (error = &std::get<Indices>(results).error())) || ...));
+        co_return make_unexpected<ErrorType>(*error);
+    }
+    co_return std::tuple<ValueTypes...>(std::move(*std::get<Indices>(results))...);
+}
+
+} // namespace detail
+
+/// Runs [tasks] concurrently and collects their values, or the error of the first of them which failed
+///
+/// Every task is started before any is awaited, so a task which suspends does not hold back the ones
+/// after it, a task which fails synchronously stops the ones after it from starting, and the returned
+/// task completes once every started task completed
+template <typename ErrorType, typename ... ValueTypes>
+task<std::tuple<ValueTypes...>, ErrorType> when_all(task<ValueTypes, ErrorType> ... tasks) {
+    return detail::when_all(std::index_sequence_for<ValueTypes...>{}, std::move(tasks)...);
+}
+
+/// Runs [tasks] concurrently and collects their values in order, or the error of the first of them
+/// which failed, as above
+template <typename ValueType, typename ErrorType>
+task<std::vector<ValueType>, ErrorType> when_all(std::vector<task<ValueType, ErrorType>> tasks) {
+    std::vector<expected<ValueType, ErrorType>> results(tasks.size());
+    detail::when_all_latch latch(tasks.size());
+    std::vector<detail::when_all_child> children;
+    children.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        children.push_back(detail::make_when_all_child(std::move(tasks[i]), results[i], latch));
+    }
+    co_await detail::when_all_awaiter(children.data(), children.size(), latch);
+
+    std::vector<ValueType> values;
+    values.reserve(results.size());
+    for (auto &result : results) {
+        if (!result.has_value()) {
+            co_return make_unexpected<ErrorType>(std::move(result).error());
+        }
+        values.push_back(std::move(*result));
+    }
+    co_return std::move(values);
+}
+
+} // namespace pstd
+
+#endif
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "expected.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Combines [expected] results keeping every error instead of only the first
+///
+///     auto request = pstd::validate(check_name(name), check_age(age), check_email(email));
+///     if (!request) {
+///         for (const Error &error : request.error()) { ... }   // Every check which failed
+///     }
+///     const auto &[valid_name, valid_age, valid_email] = *request;
+///
+/// Errors are kept in an [error_list], which stores up to a fixed number of errors inline and only
+/// allocates past that, from [std::allocator] or an arena such as [std::pmr::polymorphic_allocator]
+///
+/// [validate] knows how many errors it can get, so it never allocates, [validator] accumulates any
+/// number of checks into an [error_list] of a chosen inline capacity
+namespace pstd {
+
+/// Sequence of errors, the first [InlineCapacity] are stored inline and the rest with [Allocator]
+template <typename ErrorType, std::size_t InlineCapacity, typename Allocator = std::allocator<ErrorType>>
+class error_list {
+  public:
+    using value_type = ErrorType;
+    using iterator = ErrorType *;
+    using const_iterator = const ErrorType *;
+
+    error_list() = default;
+
+    explicit error_list(const Allocator &allocator) noexcept : overflow_(allocator) {}
+
+    void push_back(const ErrorType &error) {
+        emplace_back(error);
+    }
+
+    void push_back(ErrorType &&error) {
+        emplace_back(std::move(error));
+    }
+
+    template <typename ... Args>
+    ErrorType &emplace_back(Args && ... args) {
+        if (inline_size_ < InlineCapacity) {
+            ErrorType &error = inline_[inline_size_++];
+            error = ErrorType(std::forward<Args>(args)...);
+            return error;
+        }
+        // Past the inline capacity every error moves to [overflow_], so the errors stay contiguous
+        if (overflow_.empty()) {
+            overflow_.reserve(2 * InlineCapacity + 1);
+            for (auto &error : inline_) {
+                overflow_.push_back(std::move(error));
+            }
+        }
+        return overflow_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    /// Whether no error has been allocated
+    bool is_inline() const noexcept {
+        return overflow_.empty();
+    }
+
+    std::size_t size() const noexcept {
+        return (is_inline()) ? (inline_size_) : (overflow_.size());
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    ErrorType *data() noexcept {
+        return (is_inline()) ? (inline_.data()) : (overflow_.data());
+    }
+
+    const ErrorType *data() const noexcept {
+        return (is_inline()) ? (inline_.data()) : (overflow_.data());
+    }
+
+    ErrorType &operator[](const std::size_t index) noexcept {
+        return data()[index];
+    }
+
+    const ErrorType &operator[](const std::size_t index) const noexcept {
+        return data()[index];
+    }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+  private:
+    std::array<ErrorType, InlineCapacity> inline_{};
+    std::size_t inline_size_ = 0;
+    std::vector<ErrorType, Allocator> overflow_;
+};
+
+/// Accumulates the errors of any number of checks
+///
+///     pstd::validator<Error, 4> validator;
+///     for (const Item &item : request.items) {
+///         validator.check(check_item(item));
+///     }
+///     if (!validator) {
+///         return pstd::make_unexpected<Errors>(std::move(validator).errors());
+///     }
+template <typename ErrorType, std::size_t InlineCapacity = 8, typename Allocator = std::allocator<ErrorType>>
+class validator {
+  public:
+    using error_list_type = error_list<ErrorType, InlineCapacity, Allocator>;
+
+    validator() = default;
+
+    explicit validator(const Allocator &allocator) noexcept : errors_(allocator) {}
+
+    /// Keeps the error of [result] if it has one, returns whether it has a value
+    template <typename Expected, std::enable_if_t<detail::is_expected<std::decay_t<Expected>>::value> * = nullptr>
+    bool check(Expected &&result) {
+        if (result.has_value()) {
+            return true;
+        }
+        errors_.push_back(std::forward<Expected>(result).error());
+        return false;
+    }
+
+    /// Whether every check so far passed
+    explicit operator bool() const noexcept {
+        return errors_.empty();
+    }
+
+    const error_list_type &errors() const & noexcept {
+        return errors_;
+    }
+
+    error_list_type &&errors() && noexcept {
+        return std::move(errors_);
+    }
+
+  private:
+    error_list_type errors_;
+};
+
+/// The values of all [results] in a tuple, or the errors of all of those which failed
+template <typename ... Expecteds>
+auto validate(Expecteds && ... results) {
+    static_assert(sizeof...(Expecteds) > 0, "validate needs at least one result");
+    static_assert((detail::is_expected<std::decay_t<Expecteds>>::value && ...), "validate takes expected results");
+    using ErrorType = typename std::decay_t<std::tuple_element_t<0, std::tuple<Expecteds...>>>::error_type;
+    static_assert((std::is_same_v<typename std::decay_t<Expecteds>::error_type, ErrorType> && ...),
+                  "validate takes results of the same error type");
+    using ValuesType = std::tuple<typename std::decay_t<Expecteds>::value_type...>;
+    using ErrorsType = error_list<ErrorType, sizeof...(Expecteds)>;
+    using ResultType = expected<ValuesType, ErrorsType>;
+
+    if ((results.has_value() && ...)) {
+        return ResultType(ValuesType(*std::forward<Expecteds>(results)...));
+    }
+    ErrorsType errors;
+    ((results.has_value() || (errors.push_back(std::forward<Expecteds>(results).error()), true)), ...);
+    return ResultType(unexpected<ErrorsType>(std::move(errors)));
+}
+
+} // namespace pstd
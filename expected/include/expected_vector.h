@@ -0,0 +1,481 @@
+#pragma once
+
+#include "expected.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if __has_include(<bit>)
+#include <bit>
+#endif
+
+/// Sequence of [expected] stored as a structure of arrays: the values, the errors and a bitmap of
+/// which elements have a value each live in their own buffer
+///
+///     pstd::expected_vector<double, Error> samples;
+///     samples.push_back(read_sample());
+///     double total = 0;
+///     samples.for_each_value([&](std::size_t, double value) { total += value; });
+///
+/// Scans of the values only touch the value buffer and one bit per element, instead of the flag and
+/// padding interleaved with every [expected<double, Error>]
+///
+/// The bitmap is LSB first, element [i] has a value when bit [i % 64] of word [i / 64] is set, and the
+/// value slot of an error and the error slot of a value hold [ValueType{}] and [ErrorType{}]
+namespace pstd {
+
+namespace detail {
+
+inline int popcount64(const std::uint64_t word) noexcept {
+#if defined(__cpp_lib_bitops)
+    return std::popcount(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+/// Index of the lowest set bit, [word] must not be 0
+inline int countr_zero64(const std::uint64_t word) noexcept {
+#if defined(__cpp_lib_bitops)
+    return std::countr_zero(word);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/// Element of an [expected_vector], behaves like a reference to an [expected]
+template <typename VectorType, bool Const>
+class expected_vector_reference {
+  private:
+    using ValueType = typename VectorType::value_type::value_type;
+    using ErrorType = typename VectorType::value_type::error_type;
+    using ExpectedType = expected<ValueType, ErrorType>;
+    using VectorPointer = std::conditional_t<Const, const VectorType *, VectorType *>;
+    using ValueReference = std::conditional_t<Const, const ValueType &, ValueType &>;
+    using ErrorReference = std::conditional_t<Const, const ErrorType &, ErrorType &>;
+
+  public:
+    expected_vector_reference(const VectorPointer vector, const std::size_t index) noexcept
+        : vector_(vector), index_(index) {}
+
+    expected_vector_reference(const expected_vector_reference &) noexcept = default;
+
+    bool has_value() const noexcept {
+        return vector_->has_value(index_);
+    }
+
+    explicit operator bool() const noexcept {
+        return has_value();
+    }
+
+    ValueReference operator*() const noexcept {
+        return vector_->values_[index_];
+    }
+
+    std::remove_reference_t<ValueReference> *operator->() const noexcept {
+        return std::addressof(vector_->values_[index_]);
+    }
+
+    ValueReference value() const {
+        throw_exception<bad_optional_access>(!has_value(), "Object does not have a value");
+        return **this;
+    }
+
+    ErrorReference error() const noexcept {
+        return vector_->errors_[index_];
+    }
+
+    template <typename U>
+    ValueType value_or(U &&other) const {
+        return (has_value()) ? (**this) : (static_cast<ValueType>(std::forward<U>(other)));
+    }
+
+    /// A copy of the element
+    operator ExpectedType() const {
+        if (has_value()) {
+            return ExpectedType(**this);
+        }
+        return ExpectedType(unexpected<ErrorType>(error()));
+    }
+
+    /// Assigns the element, like assigning an [expected] from [other]
+    template <typename U, bool C = Const, std::enable_if_t<!C && std::is_constructible_v<ExpectedType, U>> * = nullptr>
+    const expected_vector_reference &operator=(U &&other) const {
+        vector_->set(index_, ExpectedType(std::forward<U>(other)));
+        return *this;
+    }
+
+    const expected_vector_reference &operator=(const expected_vector_reference &other) const {
+        static_assert(!Const, "cannot assign through a const reference");
+        vector_->set(index_, static_cast<ExpectedType>(other));
+        return *this;
+    }
+
+    friend bool operator==(const expected_vector_reference &lhs, const ExpectedType &rhs) {
+        return static_cast<ExpectedType>(lhs) == rhs;
+    }
+
+    friend bool operator!=(const expected_vector_reference &lhs, const ExpectedType &rhs) {
+        return !(lhs == rhs);
+    }
+
+  private:
+    VectorPointer vector_;
+    std::size_t index_;
+};
+
+/// Random access iterator yielding [expected_vector_reference]
+template <typename VectorType, bool Const>
+class expected_vector_iterator {
+  private:
+    using VectorPointer = std::conditional_t<Const, const VectorType *, VectorType *>;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename VectorType::value_type;
+    using reference = expected_vector_reference<VectorType, Const>;
+    using pointer = void;
+
+    expected_vector_iterator() noexcept = default;
+
+    expected_vector_iterator(const VectorPointer vector, const std::size_t index) noexcept
+        : vector_(vector), index_(index) {}
+
+    reference operator*() const noexcept { return reference(vector_, index_); }
+    reference operator[](const difference_type n) const noexcept { return reference(vector_, index_ + n); }
+
+    expected_vector_iterator &operator++() noexcept { index_++; return *this; }
+    expected_vector_iterator &operator--() noexcept { index_--; return *this; }
+    expected_vector_iterator operator++(int) noexcept { auto copy = *this; index_++; return copy; }
+    expected_vector_iterator operator--(int) noexcept { auto copy = *this; index_--; return copy; }
+    expected_vector_iterator &operator+=(const difference_type n) noexcept { index_ += n; return *this; }
+    expected_vector_iterator &operator-=(const difference_type n) noexcept { index_ -= n; return *this; }
+
+    friend expected_vector_iterator operator+(expected_vector_iterator it, const difference_type n) noexcept {
+        return it += n;
+    }
+    friend expected_vector_iterator operator+(const difference_type n, expected_vector_iterator it) noexcept {
+        return it += n;
+    }
+    friend expected_vector_iterator operator-(expected_vector_iterator it, const difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+    friend bool operator<(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+    friend bool operator>(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ > rhs.index_;
+    }
+    friend bool operator<=(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ <= rhs.index_;
+    }
+    friend bool operator>=(const expected_vector_iterator &lhs, const expected_vector_iterator &rhs) noexcept {
+        return lhs.index_ >= rhs.index_;
+    }
+
+  private:
+    VectorPointer vector_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+} // namespace detail
+
+template <typename ValueType, typename ErrorType>
+class expected_vector {
+  private:
+    static_assert(!std::is_same_v<ValueType, bool> && !std::is_same_v<ErrorType, bool>,
+                  "std::vector<bool> has no references to its elements");
+
+    using SelfType = expected_vector;
+
+    static constexpr std::size_t kWordBits = 64;
+
+  public:
+    using value_type = expected<ValueType, ErrorType>;
+    using size_type = std::size_t;
+    using reference = detail::expected_vector_reference<SelfType, false>;
+    using const_reference = detail::expected_vector_reference<SelfType, true>;
+    using iterator = detail::expected_vector_iterator<SelfType, false>;
+    using const_iterator = detail::expected_vector_iterator<SelfType, true>;
+
+    expected_vector() = default;
+
+    expected_vector(std::initializer_list<value_type> results) {
+        reserve(results.size());
+        for (const auto &result : results) {
+            push_back(result);
+        }
+    }
+
+    std::size_t size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+
+    void reserve(const std::size_t capacity) {
+        values_.reserve(capacity);
+        errors_.reserve(capacity);
+        bits_.reserve(words(capacity));
+    }
+
+    void clear() noexcept {
+        values_.clear();
+        errors_.clear();
+        bits_.clear();
+    }
+
+    void push_back(const value_type &result) {
+        if (result.has_value()) {
+            push_value(*result);
+        } else {
+            push_error(result.error());
+        }
+    }
+
+    void push_back(value_type &&result) {
+        if (result.has_value()) {
+            push_value(std::move(*result));
+        } else {
+            push_error(std::move(result).error());
+        }
+    }
+
+    /// The element is constructed before anything else changes, so a throwing constructor leaves the
+    /// vector as it was
+    template <typename ... Args>
+    ValueType &emplace_value(Args && ... args) {
+        const std::size_t index = size();
+        values_.emplace_back(std::forward<Args>(args)...);
+        try {
+            errors_.emplace_back();
+            grow(index, true);
+        } catch (...) {
+            values_.resize(index);
+            errors_.resize(index);
+            throw;
+        }
+        return values_.back();
+    }
+
+    template <typename ... Args>
+    ErrorType &emplace_error(Args && ... args) {
+        const std::size_t index = size();
+        errors_.emplace_back(std::forward<Args>(args)...);
+        try {
+            values_.emplace_back();
+            grow(index, false);
+        } catch (...) {
+            values_.resize(index);
+            errors_.resize(index);
+            throw;
+        }
+        return errors_.back();
+    }
+
+    /// Appends [count] elements from separate buffers, such as the columns of an Arrow array
+    ///
+    /// Element [i] has a value when bit [i % 8] of byte [i / 8] of [validity] is set, a null [validity]
+    /// means every element has a value and a null [errors] that every error is [ErrorType{}]
+    ///
+    /// Values are copied in bulk, only the slots of errors are visited one by one
+    void append(const ValueType *values, const ErrorType *errors, const std::uint8_t *validity,
+                const std::size_t count) {
+        const std::size_t first = size();
+        values_.insert(values_.end(), values, values + count);
+        errors_.resize(first + count);
+        bits_.resize(words(first + count));
+        if (!validity) {
+            set_bits(first, count);
+            return;
+        }
+
+        // Whole source words, then the bytes of the last partial one, shifted into place
+        const std::size_t shift = first % kWordBits;
+        for (std::size_t source = 0; source * kWordBits < count; source++) {
+            const std::size_t bits = (count - source * kWordBits < kWordBits) ? (count - source * kWordBits) : (kWordBits);
+            std::uint64_t word = 0;
+            for (std::size_t byte = 0; byte * 8 < bits; byte++) {
+                word |= static_cast<std::uint64_t>(validity[source * 8 + byte]) << (byte * 8);
+            }
+            if (bits < kWordBits) {
+                word &= (std::uint64_t{1} << bits) - 1;
+            }
+            const std::size_t target = (first + source * kWordBits) / kWordBits;
+            bits_[target] |= word << shift;
+            if (shift != 0 && target + 1 < bits_.size()) {
+                bits_[target + 1] |= word >> (kWordBits - shift);
+            }
+        }
+
+        for_each_set_in(first, first + count, ~std::uint64_t{0}, [&](const std::size_t i) {
+            values_[i] = ValueType{};
+            if (errors) {
+                errors_[i] = errors[i - first];
+            }
+        });
+    }
+
+    bool has_value(const std::size_t index) const noexcept {
+        return (bits_[index / kWordBits] >> (index % kWordBits)) & 1U;
+    }
+
+    reference operator[](const std::size_t index) noexcept { return reference(this, index); }
+    const_reference operator[](const std::size_t index) const noexcept { return const_reference(this, index); }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+    /// Number of elements which have a value
+    std::size_t count_values() const noexcept {
+        std::size_t count = 0;
+        for (const std::uint64_t word : bits_) {
+            count += static_cast<std::size_t>(detail::popcount64(word));
+        }
+        return count;
+    }
+
+    std::size_t count_errors() const noexcept {
+        return size() - count_values();
+    }
+
+    /// Calls [f(index, value)] for each element which has a value, in order
+    template <typename F>
+    void for_each_value(F &&f) {
+        for_each_set(values_, 0, f);
+    }
+
+    template <typename F>
+    void for_each_value(F &&f) const {
+        for_each_set(values_, 0, f);
+    }
+
+    /// Calls [f(index, error)] for each element which has an error, in order
+    template <typename F>
+    void for_each_error(F &&f) {
+        for_each_set(errors_, ~std::uint64_t{0}, f);
+    }
+
+    template <typename F>
+    void for_each_error(F &&f) const {
+        for_each_set(errors_, ~std::uint64_t{0}, f);
+    }
+
+    /// The bitmap, one bit per element, see above
+    const std::uint64_t *bitmap() const noexcept { return bits_.data(); }
+
+    /// The value buffer, slots of errors hold [ValueType{}]
+    const ValueType *values() const noexcept { return values_.data(); }
+
+    /// The error buffer, slots of values hold [ErrorType{}]
+    const ErrorType *errors() const noexcept { return errors_.data(); }
+
+  private:
+    template <typename, bool>
+    friend class detail::expected_vector_reference;
+
+    static std::size_t words(const std::size_t count) noexcept {
+        return (count + kWordBits - 1) / kWordBits;
+    }
+
+    /// Records the state of the element at [index], the last one
+    void grow(const std::size_t index, const bool has_value) {
+        if (index % kWordBits == 0) {
+            bits_.push_back(0);
+        }
+        bits_.back() |= static_cast<std::uint64_t>(has_value) << (index % kWordBits);
+    }
+
+    /// Sets the bits of [count] elements from [first]
+    void set_bits(const std::size_t first, const std::size_t count) noexcept {
+        for (std::size_t i = first; i < first + count; i++) {
+            bits_[i / kWordBits] |= std::uint64_t{1} << (i % kWordBits);
+        }
+    }
+
+    /// Calls [f(index)] for each index in [begin, end) whose bit XOR [flip] is set
+    template <typename F>
+    void for_each_set_in(const std::size_t begin, const std::size_t end, const std::uint64_t flip, F &&f) const {
+        for (std::size_t w = begin / kWordBits; w * kWordBits < end; w++) {
+            const std::size_t base = w * kWordBits;
+            std::uint64_t word = bits_[w] ^ flip;
+            if (begin > base) {
+                word &= ~std::uint64_t{0} << (begin - base);
+            }
+            if (end - base < kWordBits) {
+                word &= (std::uint64_t{1} << (end - base)) - 1;
+            }
+            for (; word != 0; word &= word - 1) {
+                f(base + static_cast<std::size_t>(detail::countr_zero64(word)));
+            }
+        }
+    }
+
+    template <typename U>
+    void push_value(U &&value) {
+        emplace_value(std::forward<U>(value));
+    }
+
+    template <typename U>
+    void push_error(U &&error) {
+        emplace_error(std::forward<U>(error));
+    }
+
+    void set(const std::size_t index, value_type &&result) {
+        std::uint64_t &word = bits_[index / kWordBits];
+        const std::uint64_t bit = std::uint64_t{1} << (index % kWordBits);
+        if (result.has_value()) {
+            values_[index] = std::move(*result);
+            errors_[index] = ErrorType{};
+            word |= bit;
+        } else {
+            errors_[index] = std::move(result).error();
+            values_[index] = ValueType{};
+            word &= ~bit;
+        }
+    }
+
+    /// Calls [f(index, buffer[index])] for each set bit of the bitmap XOR [flip]
+    template <typename Buffer, typename F>
+    void for_each_set(Buffer &buffer, const std::uint64_t flip, F &f) const {
+        const std::size_t count = size();
+        for (std::size_t w = 0; w < bits_.size(); w++) {
+            const std::size_t base = w * kWordBits;
+            const std::size_t bits = (count - base < kWordBits) ? (count - base) : (kWordBits);
+            const std::uint64_t valid = (bits == kWordBits) ? (~std::uint64_t{0}) : ((std::uint64_t{1} << bits) - 1);
+            std::uint64_t word = (bits_[w] ^ flip) & valid;
+            if (word == ~std::uint64_t{0}) {
+                // Dense word, a plain loop the compiler can vectorize
+                for (std::size_t i = base; i < base + kWordBits; i++) {
+                    f(i, buffer[i]);
+                }
+                continue;
+            }
+            while (word != 0) {
+                const std::size_t i = base + static_cast<std::size_t>(detail::countr_zero64(word));
+                f(i, buffer[i]);
+                word &= word - 1;
+            }
+        }
+    }
+
+    std::vector<ValueType> values_;
+    std::vector<ErrorType> errors_;
+    std::vector<std::uint64_t> bits_;
+};
+
+} // namespace pstd
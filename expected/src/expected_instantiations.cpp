@@ -0,0 +1,5 @@
+#include "expected_instantiations.h"
+
+#define PSTD_EXPECTED_TEMPLATE(V, E) template class pstd::expected<V, E>;
+PSTD_EXPECTED_INSTANTIATIONS(PSTD_EXPECTED_TEMPLATE)
+#undef PSTD_EXPECTED_TEMPLATE
@@ -0,0 +1,51 @@
+#!/bin/bash
+# Checks that [future::get] aborts on a broken promise when exceptions are disabled, as it cannot
+# throw [broken_promise] and has no result to return
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+cat > "${WORK}/main.cpp" << 'SOURCE'
+#include "expected_future.h"
+
+#include <cstdio>
+
+enum class Error { Bad };
+
+int main() {
+#if defined(__cpp_lib_atomic_wait)
+    pstd::future<int, Error> future;
+    {
+        pstd::promise<int, Error> promise;
+        future = promise.get_future();
+    }
+    const auto result = future.get();
+    std::printf("get returned %d\n", result.has_value());
+    return 0;
+#else
+    std::printf("Skipped, futures need std::atomic::wait\n");
+    return 0;
+#endif
+}
+SOURCE
+
+${CXX} -std=c++20 -fno-exceptions -DPSTD_EXPECTED_DISABLE_EXCEPTIONS -I"${ROOT}/expected/include" \
+    "${WORK}/main.cpp" -o "${WORK}/main" -pthread
+
+status=0
+output=$( ("${WORK}/main") 2> /dev/null ) || status=$?
+if [[ "${output}" == Skipped* ]]; then
+    echo "${output}"
+    exit 0
+fi
+if [[ "${status}" != 134 ]]; then
+    echo "Expected the broken promise to abort, exited with ${status}"
+    exit 1
+fi
+echo "Broken promise aborted"
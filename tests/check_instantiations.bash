@@ -0,0 +1,68 @@
+#!/bin/bash
+# Checks that including expected_instantiations.h stops a translation unit from defining the members
+# of the listed specializations, by comparing the symbols of such a unit with those of the library
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+cat > "${WORK}/tu.cpp" << 'SOURCE'
+#include HEADER
+
+#include <string>
+#include <system_error>
+
+int use(pstd::expected<std::string, std::error_code> s, pstd::expected<int, std::error_code> i,
+        pstd::expected<std::size_t, std::error_code> n, pstd::expected<bool, std::error_code> b) {
+    pstd::expected<std::string, std::error_code> copy = s;
+    copy = std::make_error_code(std::errc::invalid_argument);
+    i = 3;
+    return static_cast<int>(s.value_or("").size()) + i.value() + static_cast<int>(n.value_or(0)) +
+           static_cast<int>(b.has_value()) + static_cast<int>(copy.has_value());
+}
+SOURCE
+
+compile() {
+    ${CXX} -std=c++20 "$@" -c -I"${ROOT}/expected/include" -o "${WORK}/out.o"
+}
+
+# Mangled names of the functions an object defines
+defined() {
+    nm --defined-only "$1" | awk '$2 ~ /^[TW]$/ { print $3 }' | sort -u
+}
+
+# Mangled names of the members of [expected] the library instantiates, member templates excepted as
+# an explicit instantiation does not cover them, they demangle with their return type or arguments
+compile "${ROOT}/expected/src/expected_instantiations.cpp"
+defined "${WORK}/out.o" > "${WORK}/all.txt"
+paste "${WORK}/all.txt" <(c++filt < "${WORK}/all.txt") |
+    awk -F '\t' '$2 ~ /^pstd::expected</ {
+        member = substr($2, index($2, ">::") + 3)
+        if (index(member, "<") == 0 || index(member, "(") < index(member, "<")) print $1
+    }' > "${WORK}/library.txt"
+echo "$(wc -l < "${WORK}/library.txt") members in expected_instantiations"
+
+# Without the extern templates the unit defines some of them, which shows the check can fail
+compile -O0 -DHEADER='"expected.h"' "${WORK}/tu.cpp"
+if [[ -z "$(defined "${WORK}/out.o" | comm -12 - "${WORK}/library.txt")" ]]; then
+    echo "The unit defines no listed member even without expected_instantiations.h"
+    exit 1
+fi
+
+status=0
+for level in -O0 -O2; do
+    compile "${level}" -DHEADER='"expected_instantiations.h"' "${WORK}/tu.cpp"
+    duplicates=$(defined "${WORK}/out.o" | comm -12 - "${WORK}/library.txt")
+    printf '%-4s %d members defined outside expected_instantiations\n' "${level}" \
+        "$(grep -c . <<< "${duplicates}" || true)"
+    if [[ -n "${duplicates}" ]]; then
+        c++filt <<< "${duplicates}"
+        status=1
+    fi
+done
+exit ${status}
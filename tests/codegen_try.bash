@@ -0,0 +1,88 @@
+#!/bin/bash
+# Checks that [PSTD_TRY] and [PSTD_TRY_EXPR] cost no more than the early returns they replace, by
+# comparing the number of x86-64 instructions of each form against the hand written one
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+if [[ "$(uname -m)" != "x86_64" ]]; then
+    echo "Skipped, the assembly is only checked on x86-64"
+    exit 0
+fi
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+cat > "${WORK}/tu.cpp" << 'SOURCE'
+#include "expected.h"
+
+#include <string>
+
+enum class Error { Bad, Worse };
+using Expected = pstd::expected<int, Error>;
+using StringExpected = pstd::expected<std::string, std::string>;
+
+Expected check(int value);
+StringExpected lookup(int key);
+
+extern "C" Expected hand_written(const int a, const int b) {
+    auto x = check(a);
+    if (!x) {
+        return pstd::make_unexpected<Error>(x.error());
+    }
+    auto y = check(b);
+    if (!y) {
+        return pstd::make_unexpected<Error>(y.error());
+    }
+    return *x + *y;
+}
+
+extern "C" Expected with_try(const int a, const int b) {
+    PSTD_TRY(x, check(a));
+    PSTD_TRY(y, check(b));
+    return x + y;
+}
+
+extern "C" Expected with_try_expr(const int a, const int b) {
+    return PSTD_TRY_EXPR(check(a)) + PSTD_TRY_EXPR(check(b));
+}
+
+extern "C" StringExpected hand_written_string(const int key) {
+    auto x = lookup(key);
+    if (!x) {
+        return pstd::make_unexpected<std::string>(std::move(x).error());
+    }
+    auto value = std::move(*x);
+    return std::move(value) + "!";
+}
+
+extern "C" StringExpected with_try_string(const int key) {
+    PSTD_TRY(x, lookup(key));
+    return std::move(x) + "!";
+}
+SOURCE
+
+${CXX} -std=c++20 -O2 -S -I"${ROOT}/expected/include" "${WORK}/tu.cpp" -o "${WORK}/tu.s"
+
+# Instructions between the label of a function and its end, including its cold part
+instructions() {
+    awk "/^$1(\\.cold)?:/,/\\.cfi_endproc/" "${WORK}/tu.s" | grep -cE '^\s+[a-z]' | tr -d ' ' || true
+}
+
+status=0
+check() {
+    local reference count
+    reference=$(instructions "$1")
+    count=$(instructions "$2")
+    printf '%-20s %3d instructions, %s %d\n' "$2" "${count}" "$1" "${reference}"
+    if (( count > reference )); then
+        status=1
+    fi
+}
+check hand_written with_try
+check hand_written with_try_expr
+check hand_written_string with_try_string
+exit ${status}
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Checks that [zip] and [apply_expected] branch once on the state of the whole group, by counting
+# the conditional jumps in the x86-64 assembly of functions combining five [expected]
+set -e
+
+if [[ ! -v CXX ]]; then
+    export CXX=c++
+fi
+
+if [[ "$(uname -m)" != "x86_64" ]]; then
+    echo "Skipped, the assembly is only checked on x86-64"
+    exit 0
+fi
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "${WORK}"' EXIT
+
+cat > "${WORK}/tu.cpp" << 'SOURCE'
+#include "expected_algorithm.h"
+
+#include <new>
+
+enum class Error { Bad, Worse };
+using Expected = pstd::expected<int, Error>;
+using Zipped = pstd::expected<std::tuple<int, int, int, int, int>, Error>;
+
+extern "C" void zip5(Zipped *out, const Expected &a, const Expected &b, const Expected &c,
+                     const Expected &d, const Expected &e) {
+    new (out) Zipped(pstd::zip(a, b, c, d, e));
+}
+
+extern "C" void apply5(Expected *out, const Expected &a, const Expected &b, const Expected &c,
+                       const Expected &d, const Expected &e) {
+    new (out) Expected(pstd::apply_expected([](int v, int w, int x, int y, int z) {
+        return v + w + x + y + z;
+    }, a, b, c, d, e));
+}
+SOURCE
+
+${CXX} -std=c++20 -O2 -S -I"${ROOT}/expected/include" "${WORK}/tu.cpp" -o "${WORK}/tu.s"
+
+status=0
+for function in zip5 apply5; do
+    # Conditional jumps between the label of the function and the end of its hot part
+    branches=$(awk "/^${function}:/,/\\.cfi_endproc/" "${WORK}/tu.s" | grep -cE '^\s+j[a-ln-z]' || true)
+    printf '%-8s %d branches\n' "${function}" "${branches}"
+    if [[ "${branches}" != 1 ]]; then
+        status=1
+    fi
+done
+exit ${status}
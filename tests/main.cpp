@@ -1,2 +1,4 @@
 #define CATCH_CONFIG_MAIN
+// The bundled Catch2 sizes its alternate signal stack with MINSIGSTKSZ, which is no longer a constant in newer glibc
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include "catch.hpp"
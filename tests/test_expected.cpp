@@ -2,7 +2,9 @@
 
 #include "expected.h"
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-result"
@@ -33,6 +35,67 @@ static_assert(sizeof(Expected) == sizeof(Error) + 4);
 static_assert(pstd::detail::is_comparable_v<Data>);
 static_assert(pstd::detail::is_comparable_v<Error>);
 
+/// Counts live objects, to check that only constructed alternatives are destroyed
+struct Counted {
+    static inline int constructed = 0;
+    static inline int destroyed = 0;
+    Counted() noexcept { constructed++; }
+    Counted(const Counted &) noexcept { constructed++; }
+    Counted(Counted &&) noexcept { constructed++; }
+    Counted &operator=(const Counted &) = default;
+    Counted &operator=(Counted &&) = default;
+    ~Counted() { destroyed++; }
+};
+
+/// Counts copies and moves, to check that conversions construct straight from the source
+struct MoveCounted {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    MoveCounted() noexcept = default;
+    MoveCounted(const MoveCounted &) noexcept { copies++; }
+    MoveCounted(MoveCounted &&) noexcept { moves++; }
+    MoveCounted &operator=(const MoveCounted &) noexcept { copies++; return *this; }
+    MoveCounted &operator=(MoveCounted &&) noexcept { moves++; return *this; }
+
+    static void reset() {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+/// Throws when built from a negative number, or when moved while [throw_on_move] is set
+struct Fragile {
+    static inline int live = 0;
+    static inline bool throw_on_move = false;
+    Fragile() noexcept { live++; }
+    Fragile(const int value) {
+        if (value < 0) {
+            throw std::runtime_error("negative");
+        }
+        live++;
+    }
+    Fragile(const Fragile &) noexcept { live++; }
+    Fragile(Fragile &&) {
+        if (throw_on_move) {
+            throw std::runtime_error("move");
+        }
+        live++;
+    }
+    Fragile &operator=(const Fragile &) = default;
+    Fragile &operator=(Fragile &&) = default;
+    ~Fragile() { live--; }
+};
+
+/// Implicitly constructible from [MoveCounted]
+struct Wrapper {
+    MoveCounted inner;
+    Wrapper() noexcept = default;
+    Wrapper(const MoveCounted &inner) noexcept : inner(inner) {}
+    Wrapper(MoveCounted &&inner) noexcept : inner(std::move(inner)) {}
+    Wrapper &operator=(const MoveCounted &other) noexcept { inner = other; return *this; }
+    Wrapper &operator=(MoveCounted &&other) noexcept { inner = std::move(other); return *this; }
+};
+
 template <typename F>
 bool exception_thrown(F &&f) {
     try {
@@ -56,10 +119,31 @@ TEST_CASE("Typical", "expected") {
         SECTION("Mutable") {
             Expected e;
             REQUIRE(!has_value(e));
+            REQUIRE(e.error() == Error{});
         }
         SECTION("Immutable") {
             const Expected e;
             REQUIRE(!has_value(e));
+            REQUIRE(e.error() == Error{});
+        }
+        SECTION("Constexpr") {
+            constexpr Expected kTable[] = {Expected{}, Data{.value = 3}, Error::VeryBad};
+            static_assert(!kTable[0].has_value());
+            static_assert(kTable[0].error() == Error{});
+            static_assert(kTable[1].value().value == 3);
+            static_assert(kTable[2].error() == Error::VeryBad);
+            static_assert(std::is_trivially_destructible_v<Expected>);
+        }
+        SECTION("Lifetime") {
+            {
+                pstd::expected<std::string, Counted> e;
+                REQUIRE(Counted::constructed - Counted::destroyed == 1);
+                e = std::string("value");
+                REQUIRE(Counted::constructed == Counted::destroyed);
+                pstd::expected<std::string, Counted> copy = e;
+                REQUIRE(*copy == "value");
+            }
+            REQUIRE(Counted::constructed == Counted::destroyed);
         }
     }
 }
@@ -80,6 +164,12 @@ TEST_CASE("Assignment", "expected") {
             REQUIRE(!has_value(e));
             REQUIRE(e.error() == kError);
         }
+        SECTION("Convertible Error") {
+            pstd::expected<int, std::string> e = 1;
+            e = "oops";
+            REQUIRE(!e.has_value());
+            REQUIRE(e.error() == "oops");
+        }
         SECTION("EmptyBraces") {
             // Start with no value
             Expected e;
@@ -189,6 +279,16 @@ TEST_CASE("InPlaceConstruction", "expected") {
         REQUIRE(e.error().y == kY);
         REQUIRE(e.error().z == kZ);
     }
+    SECTION("Namespace Tags") {
+        static_assert(std::is_same_v<Type::in_place, pstd::in_place_t>);
+        static_assert(std::is_same_v<Type::unexpect, pstd::unexpect_t>);
+        Type v(pstd::in_place, kX, kY, kZ);
+        REQUIRE(has_value(v));
+        REQUIRE(v.value().z == kZ);
+        Type e(pstd::unexpect, kX, kY, kZ);
+        REQUIRE(!has_value(e));
+        REQUIRE(e.error().z == kZ);
+    }
     SECTION("Alternating") {
         // Value
         Type e(Type::in_place{}, kX, kY, kZ);
@@ -217,6 +317,40 @@ TEST_CASE("InPlaceConstruction", "expected") {
     }
 }
 
+TEST_CASE("Emplace", "expected") {
+    using Buffer = std::string;
+    using Type = pstd::expected<Buffer, Error>;
+
+    SECTION("Returns Reference") {
+        Type e;
+        Buffer &value = e.emplace(Type::in_place{}, 3U, 'x');
+        REQUIRE(&value == &*e);
+        REQUIRE(value == "xxx");
+
+        Error &error = e.emplace(Type::unexpect{}, Error::Terrible);
+        REQUIRE(&error == &e.error());
+        REQUIRE(error == Error::Terrible);
+    }
+    SECTION("Assign Or Emplace") {
+        constexpr std::size_t kCapacity = 1'000;
+
+        // Emplaces over an error
+        Type e = Error::Bad;
+        Buffer &value = e.assign_or_emplace("first");
+        REQUIRE(e.has_value());
+        REQUIRE(value == "first");
+
+        // Assigns over a value, keeping its capacity
+        value.reserve(kCapacity);
+        const auto *const data = value.data();
+        Buffer &reused = e.assign_or_emplace("second");
+        REQUIRE(&reused == &value);
+        REQUIRE(reused == "second");
+        REQUIRE(reused.capacity() >= kCapacity);
+        REQUIRE(reused.data() == data);
+    }
+}
+
 TEST_CASE("Factory", "expected") {
     constexpr auto x = pstd::make_unexpected<Error>(Error::Terrible);
     static_assert(std::is_same_v<decltype(x)::Type, Error>);
@@ -226,6 +360,161 @@ TEST_CASE("Factory", "expected") {
     REQUIRE(e.error() == Error::Terrible);
 }
 
+TEST_CASE("FromUnexpected", "expected") {
+    using Type = pstd::expected<int, MoveCounted>;
+
+    SECTION("Construction") {
+        pstd::unexpected<MoveCounted> error{MoveCounted{}};
+        MoveCounted::reset();
+        const Type moved = std::move(error);
+        REQUIRE(!moved.has_value());
+        REQUIRE(MoveCounted::moves == 1);
+        REQUIRE(MoveCounted::copies == 0);
+
+        MoveCounted::reset();
+        const Type copied = error;
+        REQUIRE(!copied.has_value());
+        REQUIRE(MoveCounted::moves == 0);
+        REQUIRE(MoveCounted::copies == 1);
+    }
+    SECTION("Assignment") {
+        pstd::unexpected<MoveCounted> error{MoveCounted{}};
+
+        // Replaces the value
+        Type e = 5;
+        MoveCounted::reset();
+        e = std::move(error);
+        REQUIRE(!e.has_value());
+        REQUIRE(MoveCounted::moves == 1);
+        REQUIRE(MoveCounted::copies == 0);
+
+        // Assigns over the error
+        MoveCounted::reset();
+        e = std::move(error);
+        REQUIRE(MoveCounted::moves == 1);
+        e = error;
+        REQUIRE(MoveCounted::copies == 1);
+        REQUIRE(MoveCounted::moves == 1);
+    }
+    SECTION("Converting") {
+        const pstd::expected<std::string, long> e = pstd::make_unexpected<int>(3);
+        REQUIRE(e.error() == 3L);
+    }
+}
+
+TEST_CASE("SameTypes", "expected") {
+    SECTION("Integral") {
+        using Type = pstd::expected<int, int>;
+
+        // A bare int is always the value
+        Type value = 5;
+        REQUIRE(has_value(value));
+        REQUIRE(*value == 5);
+
+        // Errors are given by tag or [unexpected]
+        Type tagged(pstd::unexpect, 6);
+        REQUIRE(!has_value(tagged));
+        REQUIRE(tagged.error() == 6);
+
+        Type wrapped = pstd::make_unexpected<int>(7);
+        REQUIRE(wrapped.error() == 7);
+
+        value = pstd::make_unexpected<int>(8);
+        REQUIRE(value.error() == 8);
+        value = 9;
+        REQUIRE(*value == 9);
+
+        REQUIRE(value == 9);
+        REQUIRE(tagged == pstd::make_unexpected<int>(6));
+        REQUIRE(value < tagged);
+    }
+    SECTION("String") {
+        using Type = pstd::expected<std::string, std::string>;
+
+        Type e(pstd::in_place, std::string("value"));
+        REQUIRE(*e == "value");
+        e = pstd::make_unexpected<std::string>("error");
+        REQUIRE(e.error() == "error");
+        e.emplace(pstd::in_place, "again");
+        REQUIRE(*e == "again");
+
+        Type copy = e;
+        REQUIRE(copy == e);
+        pstd::swap(copy, e);
+        REQUIRE(e.value_or("other") == "again");
+    }
+}
+
+pstd::expected<MoveCounted, Error> make_counted(const bool succeed) {
+    if (succeed) {
+        return pstd::expected<MoveCounted, Error>(pstd::in_place);
+    }
+    return Error::VeryBad;
+}
+
+pstd::expected<int, Error> hand_written(const bool succeed) {
+    auto result = make_counted(succeed);
+    if (!result) {
+        return pstd::make_unexpected<Error>(result.error());
+    }
+    auto value = std::move(*result);
+    static_cast<void>(value);
+    return 1;
+}
+
+pstd::expected<int, Error> with_try(const bool succeed) {
+    PSTD_TRY(value, make_counted(succeed));
+    static_cast<void>(value);
+    return 1;
+}
+
+pstd::expected<int, Error> with_try_expr(const bool succeed) {
+    const pstd::expected<int, Error> lvalue = 2;
+    const int sum = PSTD_TRY_EXPR(lvalue) + PSTD_TRY_EXPR(pstd::expected<int, Error>(succeed ? 3 : 4));
+    if (!succeed) {
+        PSTD_TRY_EXPR(make_counted(succeed));
+    }
+    return sum;
+}
+
+pstd::expected<int, std::string> with_try_string(const pstd::expected<int, std::string> &lvalue) {
+    PSTD_TRY(value, lvalue);
+    return value + 1;
+}
+
+pstd::expected<int, std::string> with_try_converted(const pstd::expected<int, const char *> &lvalue) {
+    PSTD_TRY(value, lvalue);
+    return value + PSTD_TRY_EXPR(lvalue);
+}
+
+TEST_CASE("Try", "expected") {
+    SECTION("Value") {
+        MoveCounted::reset();
+        REQUIRE(*hand_written(true) == 1);
+        const int hand_written_moves = MoveCounted::moves;
+
+        MoveCounted::reset();
+        REQUIRE(*with_try(true) == 1);
+        REQUIRE(MoveCounted::moves == hand_written_moves);
+        REQUIRE(MoveCounted::copies == 0);
+
+        REQUIRE(*with_try_expr(true) == 5);
+    }
+    SECTION("Error") {
+        REQUIRE(with_try(false).error() == Error::VeryBad);
+        REQUIRE(with_try_expr(false).error() == Error::VeryBad);
+    }
+    SECTION("Throwing Error Copy") {
+        const pstd::expected<int, std::string> failed = pstd::make_unexpected<std::string>("failed");
+        REQUIRE(with_try_string(failed).error() == "failed");
+        REQUIRE(failed.error() == "failed");
+        REQUIRE(*with_try_string(1) == 2);
+
+        REQUIRE(with_try_converted(pstd::make_unexpected<const char *>("converted")).error() == "converted");
+        REQUIRE(*with_try_converted(3) == 6);
+    }
+}
+
 TEST_CASE("Dereference", "expected") {
     constexpr int kValue = 127127;
     constexpr int kOtherValue = 888888;
@@ -377,6 +666,222 @@ TEST_CASE("Comparison", "expected") {
     }
 }
 
+/// Error with a non trivial destructor, to exercise constexpr destruction
+struct ConstexprError {
+    int code = 0;
+    constexpr ConstexprError() noexcept = default;
+    constexpr ConstexprError(int code) noexcept : code(code) {}
+    constexpr ~ConstexprError() {}
+};
+
+/// Runs every state change of [expected] in a constant expression
+constexpr int constexpr_state_changes() {
+    using Type = pstd::expected<int, ConstexprError>;
+    Type a;
+    Type b = 2;
+    a.emplace(Type::in_place{}, 3);
+    b.emplace(Type::unexpect{}, 4);
+    pstd::swap(a, b);
+    a = 5;
+    b = ConstexprError{6};
+    Type c = a;
+    c.value() += 10;
+    c = b;
+    c.error().code += 100;
+    return a.value() + b.error().code + c.error().code;
+}
+
+TEST_CASE("Conversion", "expected") {
+    enum class ParseError { Syntax, Overflow };
+
+    struct AppError {
+        int code = 0;
+        AppError() noexcept = default;
+        AppError(ParseError error) noexcept : code(static_cast<int>(error) + 100) {}
+    };
+
+    SECTION("Explicit") {
+        using Source = pstd::expected<std::string_view, ParseError>;
+        using Target = pstd::expected<std::string, AppError>;
+        static_assert(std::is_constructible_v<Target, const Source &>);
+        static_assert(!std::is_convertible_v<const Source &, Target>);
+
+        const Source source = std::string_view("text");
+        const Target target(source);
+        REQUIRE(*target == "text");
+
+        const Source error = ParseError::Overflow;
+        const Target converted(error);
+        REQUIRE(converted.error().code == 101);
+    }
+    SECTION("Implicit") {
+        using Source = pstd::expected<int, ParseError>;
+        using Target = pstd::expected<long, AppError>;
+        static_assert(std::is_convertible_v<const Source &, Target>);
+        static_assert(std::is_convertible_v<Source &&, Target>);
+
+        const Target value = Source{5};
+        REQUIRE(*value == 5L);
+        const Target error = Source{ParseError::Syntax};
+        REQUIRE(error.error().code == 100);
+    }
+    SECTION("MoveCount") {
+        using Source = pstd::expected<MoveCounted, ParseError>;
+        using Target = pstd::expected<Wrapper, AppError>;
+
+        Source source(pstd::in_place);
+        MoveCounted::reset();
+        Target target = std::move(source);
+        REQUIRE(target.has_value());
+        REQUIRE(MoveCounted::moves == 1);
+        REQUIRE(MoveCounted::copies == 0);
+
+        MoveCounted::reset();
+        Target copied = source;
+        REQUIRE(MoveCounted::moves == 0);
+        REQUIRE(MoveCounted::copies == 1);
+    }
+    SECTION("Assignment") {
+        using Source = pstd::expected<MoveCounted, ParseError>;
+        using Target = pstd::expected<Wrapper, AppError>;
+
+        // Same alternative assigns in place
+        Source source(pstd::in_place);
+        Target target(pstd::in_place);
+        MoveCounted::reset();
+        target = std::move(source);
+        REQUIRE(MoveCounted::moves == 1);
+        REQUIRE(MoveCounted::copies == 0);
+
+        // Different alternative reconstructs
+        target = Source{ParseError::Overflow};
+        REQUIRE(!target.has_value());
+        REQUIRE(target.error().code == 101);
+
+        MoveCounted::reset();
+        target = source;
+        REQUIRE(target.has_value());
+        REQUIRE(MoveCounted::copies == 1);
+        REQUIRE(MoveCounted::moves == 0);
+    }
+    SECTION("Throwing Reconstruction") {
+        using Source = pstd::expected<int, ParseError>;
+        using Target = pstd::expected<Fragile, AppError>;
+
+        {
+            Target target = Source{ParseError::Overflow};
+
+            // A throwing conversion leaves the error in place
+            REQUIRE_THROWS_AS(target = Source{-1}, std::runtime_error);
+            REQUIRE(!target.has_value());
+            REQUIRE(target.error().code == 101);
+
+            // A throwing move leaves a value initialized error rather than a destroyed one
+            Fragile::throw_on_move = true;
+            REQUIRE_THROWS_AS(target = Source{1}, std::runtime_error);
+            Fragile::throw_on_move = false;
+            REQUIRE(!target.has_value());
+            REQUIRE(target.error().code == 0);
+            REQUIRE(Fragile::live == 0);
+
+            target = Source{1};
+            REQUIRE(target.has_value());
+            REQUIRE(Fragile::live == 1);
+        }
+        REQUIRE(Fragile::live == 0);
+    }
+}
+
+TEST_CASE("HeterogeneousComparison", "expected") {
+    /// Neither copyable nor movable, so no temporary [expected] can be made from it
+    struct Id {
+        int id = 0;
+        Id() noexcept = default;
+        explicit Id(int id) noexcept : id(id) {}
+        Id(const Id &) = delete;
+        Id &operator=(const Id &) = delete;
+        bool operator==(int other) const { return id == other; }
+    };
+
+    SECTION("Value") {
+        const Expected e = Data{.value = 5};
+        REQUIRE(e == Data{5});
+        REQUIRE(Data{5} == e);
+        REQUIRE(e != Data{6});
+        REQUIRE(Data{6} != e);
+
+        const Expected error = Error::Bad;
+        REQUIRE(error != Data{5});
+
+        const pstd::expected<std::string, Error> name = std::string("name");
+        REQUIRE(name == "name");
+        REQUIRE("other" != name);
+
+        const pstd::expected<Id, Error> id(pstd::in_place, 3);
+        REQUIRE(id == 3);
+        REQUIRE(id != 4);
+    }
+    SECTION("Unexpected") {
+        const Expected e = Error::Bad;
+        REQUIRE(e == pstd::make_unexpected<Error>(Error::Bad));
+        REQUIRE(pstd::make_unexpected<Error>(Error::Bad) == e);
+        REQUIRE(e != pstd::make_unexpected<Error>(Error::Terrible));
+
+        const Expected value = Data{};
+        REQUIRE(value != pstd::make_unexpected<Error>(Error{}));
+
+        const pstd::expected<int, Id> id(pstd::unexpect, 9);
+        REQUIRE(id == pstd::make_unexpected<int>(9));
+        REQUIRE(id != pstd::make_unexpected<int>(8));
+    }
+}
+
+TEST_CASE("Ordering", "expected") {
+    SECTION("Equal Objects Are Not Greater") {
+        const Expected a{Data{.value = 1}};
+        const Expected b{Data{.value = 1}};
+        REQUIRE(!(a > b));
+        REQUIRE(!(a < b));
+        REQUIRE(a <= b);
+        REQUIRE(a >= b);
+
+        const pstd::unexpected<Error> u1{Error::Bad};
+        const pstd::unexpected<Error> u2{Error::Bad};
+        REQUIRE(!(u1 > u2));
+        REQUIRE(!(u1 < u2));
+    }
+    SECTION("Values Before Errors") {
+        const Expected value{Data{.value = 1'000}};
+        const Expected error{Error::Bad};
+        REQUIRE(value < error);
+        REQUIRE(error > value);
+        REQUIRE(!(error < value));
+    }
+#if defined(PSTD_EXPECTED_HAS_THREE_WAY_COMPARISON)
+    SECTION("Three Way") {
+        using Integral = pstd::expected<int, Error>;
+        static_assert(std::is_same_v<decltype(Integral{} <=> Integral{}), std::strong_ordering>);
+        static_assert(std::is_same_v<decltype(Expected{} <=> Expected{}), std::weak_ordering>);
+
+        static_assert((Integral{-5} <=> Integral{3}) < 0);
+        static_assert((Integral{3} <=> Integral{3}) == 0);
+        static_assert((Integral{7} <=> Integral{Error::Bad}) < 0);
+        static_assert((Integral{Error::Terrible} <=> Integral{Error::Bad}) > 0);
+        static_assert((Integral{-1} <=> Integral{Error::Bad}) < 0);
+
+        REQUIRE(std::is_gt(Expected{Data{.value = 2}} <=> Expected{Data{.value = 1}}));
+        REQUIRE(std::is_eq(Expected{Error::VeryBad} <=> Expected{Error::VeryBad}));
+        REQUIRE(std::is_gt(Expected{Error::Bad} <=> Expected{Data{}}));
+    }
+#endif
+}
+
+TEST_CASE("Constexpr", "expected") {
+    static_assert(!std::is_trivially_destructible_v<pstd::expected<int, ConstexprError>>);
+    static_assert(constexpr_state_changes() == 5 + 6 + 106);
+    REQUIRE(constexpr_state_changes() == 5 + 6 + 106);
+}
+
 TEST_CASE("Swap", "expected") {
     SECTION("Expected") {
         constexpr int kValueA = 777'777;
@@ -0,0 +1,168 @@
+#include "catch.hpp"
+
+#include "expected_algorithm.h"
+
+#include <array>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    Bad,
+    Worse,
+};
+
+struct MoveCounted {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    MoveCounted() noexcept = default;
+    MoveCounted(const MoveCounted &) noexcept { copies++; }
+    MoveCounted(MoveCounted &&) noexcept { moves++; }
+    MoveCounted &operator=(const MoveCounted &) noexcept { copies++; return *this; }
+    MoveCounted &operator=(MoveCounted &&) noexcept { moves++; return *this; }
+
+    static void reset() {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+using Expected = pstd::expected<int, Error>;
+
+TEST_CASE("Collect", "expected") {
+    SECTION("Values") {
+        const std::vector<Expected> results = {1, 2, 3};
+        const auto values = pstd::collect(results);
+        REQUIRE(values.has_value());
+        REQUIRE(*values == std::vector<int>{1, 2, 3});
+    }
+    SECTION("First Error") {
+        const std::vector<Expected> results = {1, Error::Worse, 3, Error::Bad};
+        REQUIRE(pstd::collect(results).error() == Error::Worse);
+    }
+    SECTION("Empty") {
+        const auto values = pstd::collect(std::vector<Expected>());
+        REQUIRE(values.has_value());
+        REQUIRE(values->empty());
+    }
+    SECTION("Reserved") {
+        const std::list<Expected> results = {1, 2, 3};
+        const auto values = pstd::collect(results);
+        REQUIRE(values->capacity() == 3);
+    }
+    SECTION("Moved Once") {
+        std::vector<pstd::expected<MoveCounted, Error>> results(100, MoveCounted());
+        MoveCounted::reset();
+        const auto values = pstd::collect(std::move(results));
+        REQUIRE(values->size() == 100);
+        REQUIRE(MoveCounted::moves == 100);
+        REQUIRE(MoveCounted::copies == 0);
+    }
+    SECTION("Copied Once") {
+        const std::vector<pstd::expected<MoveCounted, Error>> results(100, MoveCounted());
+        MoveCounted::reset();
+        const auto values = pstd::collect(results);
+        REQUIRE(values->size() == 100);
+        REQUIRE(MoveCounted::copies == 100);
+        REQUIRE(MoveCounted::moves == 0);
+    }
+    SECTION("Moved Error") {
+        std::vector<pstd::expected<int, std::string>> results = {1, pstd::make_unexpected<std::string>("bad")};
+        REQUIRE(pstd::collect(std::move(results)).error() == "bad");
+    }
+}
+
+TEST_CASE("Zip", "expected") {
+    SECTION("Values") {
+        const Expected a = 1;
+        const pstd::expected<std::string, Error> b = std::string("two");
+        const auto zipped = pstd::zip(a, b, Expected(3));
+        REQUIRE(zipped.has_value());
+        REQUIRE(*zipped == std::make_tuple(1, std::string("two"), 3));
+    }
+    SECTION("First Error") {
+        const auto zipped = pstd::zip(Expected(1), Expected(Error::Worse), Expected(Error::Bad));
+        REQUIRE(zipped.error() == Error::Worse);
+    }
+    SECTION("Moved") {
+        // Into the tuple, then the tuple into the result
+        pstd::expected<MoveCounted, Error> a = MoveCounted();
+        MoveCounted::reset();
+        const auto zipped = pstd::zip(std::move(a), Expected(1));
+        REQUIRE(MoveCounted::moves == 2);
+        REQUIRE(MoveCounted::copies == 0);
+    }
+}
+
+TEST_CASE("ApplyExpected", "expected") {
+    const auto sum = [](const int a, const int b, const int c) { return a + b + c; };
+    SECTION("Values") {
+        REQUIRE(pstd::apply_expected(sum, Expected(1), Expected(2), Expected(3)) == 6);
+    }
+    SECTION("First Error") {
+        REQUIRE(pstd::apply_expected(sum, Expected(1), Expected(Error::Bad), Expected(Error::Worse)).error() ==
+                Error::Bad);
+    }
+    SECTION("Not Called On Error") {
+        bool called = false;
+        const auto result = pstd::apply_expected([&](const int) { called = true; return 0; }, Expected(Error::Bad));
+        REQUIRE(!result.has_value());
+        REQUIRE(!called);
+    }
+    SECTION("Returning Expected") {
+        const auto divide = [](const int a, const int b) -> Expected {
+            if (b == 0) {
+                return Error::Worse;
+            }
+            return a / b;
+        };
+        const Expected quotient = pstd::apply_expected(divide, Expected(6), Expected(3));
+        REQUIRE(quotient == 2);
+        REQUIRE(pstd::apply_expected(divide, Expected(6), Expected(0)).error() == Error::Worse);
+    }
+}
+
+#if defined(__cpp_lib_span)
+TEST_CASE("CollectSpan", "expected") {
+    SECTION("Values") {
+        const std::vector<Expected> results = {1, 2, 3};
+        std::array<int, 4> out = {};
+        const auto written = pstd::collect(results, std::span<int>(out));
+        REQUIRE(written->size() == 3);
+        REQUIRE(written->data() == out.data());
+        REQUIRE(out == std::array<int, 4>{1, 2, 3, 0});
+    }
+    SECTION("Full") {
+        const std::vector<Expected> results = {1, 2};
+        std::array<int, 2> out = {};
+        REQUIRE(pstd::collect(results, std::span<int, 2>(out))->size() == 2);
+        REQUIRE(out == std::array<int, 2>{1, 2});
+    }
+    SECTION("Longer Than Span") {
+        std::array<int, 2> out = {};
+        const std::vector<Expected> failed = {1, 2, Error::Bad};
+        REQUIRE(pstd::collect(failed, std::span<int>(out)).error() == Error::Bad);
+
+        const std::vector<Expected> results = {1, 2, 3};
+        REQUIRE_THROWS_AS(pstd::collect(results, std::span<int>(out)), std::length_error);
+    }
+    SECTION("First Error") {
+        const std::vector<Expected> results = {1, Error::Bad, 3};
+        std::array<int, 3> out = {};
+        REQUIRE(pstd::collect(results, std::span<int>(out)).error() == Error::Bad);
+    }
+    SECTION("Moved Once") {
+        std::vector<pstd::expected<MoveCounted, Error>> results(10, MoveCounted());
+        std::array<MoveCounted, 10> out;
+        MoveCounted::reset();
+        REQUIRE(pstd::collect(std::move(results), std::span<MoveCounted>(out))->size() == 10);
+        REQUIRE(MoveCounted::moves == 10);
+        REQUIRE(MoveCounted::copies == 0);
+    }
+}
+#endif
+
+} // namespace
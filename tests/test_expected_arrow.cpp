@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include "expected_arrow.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    None,
+    Bad,
+    Worse,
+};
+
+using Expected = pstd::expected<std::int32_t, Error>;
+using Vector = pstd::expected_vector<std::int32_t, Error>;
+using Column = pstd::arrow_column<std::int32_t, Error>;
+
+TEST_CASE("ExpectedArrow", "expected") {
+    SECTION("Export") {
+        Vector vector = {1, Error::Bad, 3, 4, Error::Worse};
+        const Column column = pstd::export_arrow(vector);
+        REQUIRE(column.length == 5);
+        REQUIRE(column.null_count == 2);
+        REQUIRE(column.validity[0] == 0b01101);
+        REQUIRE(column.values == vector.values());
+        REQUIRE(column.values[2] == 3);
+        REQUIRE(column.errors[4] == Error::Worse);
+        REQUIRE(column[0] == Expected(1));
+        REQUIRE(column[1].error() == Error::Bad);
+    }
+    SECTION("Round trip") {
+        Vector vector;
+        for (std::int32_t i = 0; i < 1000; i++) {
+            if (i % 7 == 0) {
+                vector.push_back(pstd::make_unexpected<Error>(Error::Bad));
+            } else {
+                vector.push_back(i);
+            }
+        }
+        const Vector copy = pstd::import_arrow(pstd::export_arrow(vector));
+        REQUIRE(copy.size() == vector.size());
+        REQUIRE(copy.count_errors() == vector.count_errors());
+        for (std::size_t i = 0; i < vector.size(); i++) {
+            REQUIRE(copy[i] == vector[i]);
+        }
+    }
+    SECTION("Import") {
+        // Arrow does not define the value of nulls or the padding bits of the bitmap
+        const std::vector<std::int32_t> values = {1, 99, 3, 99, 5, 6, 7, 8, 9, 99};
+        const std::vector<Error> errors = {Error::Worse, Error::Bad, Error::Worse, Error::Bad, Error::Worse,
+                                           Error::Worse, Error::Worse, Error::Worse, Error::Worse, Error::Bad};
+        const std::vector<std::uint8_t> validity = {0b11110101, 0b11111101};
+        Column column;
+        column.length = 10;
+        column.validity = validity.data();
+        column.values = values.data();
+        column.errors = errors.data();
+
+        const Vector vector = pstd::import_arrow(column);
+        REQUIRE(vector.size() == 10);
+        REQUIRE(vector.count_errors() == 3);
+        REQUIRE(vector.bitmap()[0] == 0b0111110101);
+        REQUIRE(vector[1].error() == Error::Bad);
+        REQUIRE(vector[9].error() == Error::Bad);
+        REQUIRE(vector[8] == Expected(9));
+        REQUIRE(vector.values()[3] == 0);
+        REQUIRE(vector.errors()[0] == Error::None);
+    }
+    SECTION("Without validity or errors") {
+        const std::vector<std::int32_t> values = {1, 2, 3};
+        Column column;
+        column.length = 3;
+        column.values = values.data();
+        REQUIRE(column[2] == Expected(3));
+
+        const Vector vector = pstd::import_arrow(column);
+        REQUIRE(vector.count_values() == 3);
+
+        const std::uint8_t validity = 0b101;
+        column.validity = &validity;
+        REQUIRE(column[1].error() == Error::None);
+        REQUIRE(pstd::import_arrow(column)[1].error() == Error::None);
+    }
+    SECTION("Vector of expected") {
+        std::vector<Expected> results;
+        for (std::int32_t i = 0; i < 100; i++) {
+            if (i % 9 == 0) {
+                results.push_back(pstd::make_unexpected<Error>((i % 2 == 0) ? (Error::Bad) : (Error::Worse)));
+            } else {
+                results.push_back(i);
+            }
+        }
+        const pstd::arrow_buffers<std::int32_t, Error> buffers = pstd::export_arrow(results);
+        REQUIRE(buffers.null_count == 12);
+        REQUIRE(buffers.validity.size() == 16);
+        REQUIRE(buffers.validity[0] == 0b11111110);
+        REQUIRE(buffers.validity[12] == 0b0111);
+        REQUIRE(buffers.values[9] == 0);
+        REQUIRE(buffers.errors[9] == Error::Worse);
+        REQUIRE(buffers.errors[1] == Error::None);
+
+        const Column column = buffers.column();
+        REQUIRE(column.length == 100);
+        REQUIRE(pstd::import_arrow_results(column) == results);
+
+        // Through the same layout as an expected_vector
+        const Vector vector = pstd::import_arrow(column);
+        REQUIRE(pstd::import_arrow_results(pstd::export_arrow(vector)) == results);
+    }
+    SECTION("Append unaligned") {
+        std::vector<std::uint8_t> validity(25);
+        std::vector<std::int32_t> values(200);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<std::int32_t>(i);
+            if (i % 3 != 0) {
+                validity[i / 8] |= static_cast<std::uint8_t>(1U << (i % 8));
+            }
+        }
+        Vector vector = {Error::Worse, 1, 2};
+        vector.append(values.data(), nullptr, validity.data(), values.size());
+        REQUIRE(vector.size() == 203);
+        REQUIRE(vector[0].error() == Error::Worse);
+        REQUIRE(vector[1] == Expected(1));
+        for (std::size_t i = 0; i < values.size(); i++) {
+            if (i % 3 != 0) {
+                REQUIRE(vector[3 + i] == Expected(static_cast<std::int32_t>(i)));
+            } else {
+                REQUIRE(vector[3 + i].error() == Error::None);
+            }
+        }
+        REQUIRE(vector.count_errors() == 1 + 67);
+    }
+}
+
+} // namespace
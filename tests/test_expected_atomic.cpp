@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "expected_atomic.h"
+
+#include <thread>
+#include <vector>
+
+#if defined(__cpp_lib_atomic_wait) && defined(__SIZEOF_INT128__)
+
+namespace {
+
+enum class Error : std::uint8_t {
+    Pending,
+    Failed,
+};
+
+struct Pair {
+    std::uint32_t first;
+    std::uint32_t second;
+};
+
+using Small = pstd::atomic_expected<std::uint16_t, Error>;
+using Medium = pstd::atomic_expected<std::uint32_t, Error>;
+using Large = pstd::atomic_expected<Pair, Error>;
+
+TEST_CASE("AtomicExpected", "expected") {
+    SECTION("Word Size") {
+        STATIC_REQUIRE(sizeof(Small) == 4);
+        STATIC_REQUIRE(sizeof(Medium) == 8);
+        STATIC_REQUIRE(sizeof(Large) == 16);
+        STATIC_REQUIRE(Medium::is_always_lock_free);
+    }
+    SECTION("Load Store") {
+        Medium slot;
+        REQUIRE(slot.load() == pstd::expected<std::uint32_t, Error>());
+        slot.store(7U);
+        REQUIRE(slot.load() == 7U);
+        slot.store(pstd::make_unexpected<Error>(Error::Failed));
+        REQUIRE(slot.load().error() == Error::Failed);
+        REQUIRE(slot.exchange(8U).error() == Error::Failed);
+        REQUIRE(slot.load() == 8U);
+    }
+    SECTION("Value Equal To Error") {
+        // A value and an error with the same bytes are told apart by the state byte
+        Small slot{pstd::make_unexpected<Error>(Error::Failed)};
+        pstd::expected<std::uint16_t, Error> current = std::uint16_t{1};
+        REQUIRE(!slot.compare_exchange_strong(current, std::uint16_t{2}));
+        REQUIRE(current.error() == Error::Failed);
+    }
+    SECTION("Compare Exchange") {
+        Large slot{pstd::make_unexpected<Error>(Error::Pending)};
+        pstd::expected<Pair, Error> current = pstd::make_unexpected<Error>(Error::Pending);
+        REQUIRE(slot.compare_exchange_strong(current, Pair{1, 2}));
+        REQUIRE(slot.load()->first == 1);
+        REQUIRE(slot.load()->second == 2);
+
+        current = pstd::make_unexpected<Error>(Error::Pending);
+        REQUIRE(!slot.compare_exchange_strong(current, Pair{3, 4}));
+        REQUIRE(current->first == 1);
+        REQUIRE(slot.compare_exchange_strong(current, Pair{3, 4}));
+        REQUIRE(slot.load()->first == 3);
+    }
+    SECTION("Wait") {
+        const pstd::expected<std::uint32_t, Error> pending = pstd::make_unexpected<Error>(Error::Pending);
+        Medium slot{pending};
+        std::vector<std::thread> readers;
+        std::vector<std::uint32_t> results(4);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            readers.emplace_back([&, i] { results[i] = *slot.wait(pending); });
+        }
+        slot.store(42U);
+        slot.notify_all();
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        REQUIRE(results == std::vector<std::uint32_t>(4, 42U));
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+
+#include "expected_coroutine.h"
+
+#include <memory>
+#include <string>
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+
+enum class Error {
+    Bad,
+    Terrible,
+};
+
+using Expected = pstd::expected<int, Error>;
+
+int resumed = 0;
+
+Expected succeed(const int value) {
+    return value;
+}
+
+Expected fail(const Error error) {
+    return error;
+}
+
+Expected add(Expected a, Expected b) {
+    const int x = co_await a;
+    resumed++;
+    const int y = co_await std::move(b);
+    resumed++;
+    co_return x + y;
+}
+
+pstd::expected<std::string, Error> describe(const Expected &e) {
+    const int &value = co_await e;
+    co_return std::to_string(value);
+}
+
+Expected forward(const Expected e) {
+    co_return co_await e;
+}
+
+Expected return_unexpected() {
+    co_return pstd::make_unexpected<Error>(Error::Terrible);
+}
+
+TEST_CASE("Coroutine", "expected") {
+    SECTION("Values") {
+        resumed = 0;
+        const Expected sum = add(succeed(2), succeed(3));
+        REQUIRE(sum.has_value());
+        REQUIRE(*sum == 5);
+        REQUIRE(resumed == 2);
+    }
+    SECTION("Short Circuit") {
+        resumed = 0;
+        const Expected first = add(fail(Error::Bad), succeed(3));
+        REQUIRE(!first.has_value());
+        REQUIRE(first.error() == Error::Bad);
+        REQUIRE(resumed == 0);
+
+        const Expected second = add(succeed(2), fail(Error::Terrible));
+        REQUIRE(second.error() == Error::Terrible);
+        REQUIRE(resumed == 1);
+    }
+    SECTION("Different Value Types") {
+        REQUIRE(*describe(succeed(42)) == "42");
+        REQUIRE(describe(fail(Error::Bad)).error() == Error::Bad);
+    }
+    SECTION("Return") {
+        REQUIRE(*forward(succeed(7)) == 7);
+        REQUIRE(forward(fail(Error::Terrible)).error() == Error::Terrible);
+        REQUIRE(return_unexpected().error() == Error::Terrible);
+    }
+    SECTION("Deferred Conversion") {
+        // The return object is converted once the coroutine ended, as GCC and Clang do
+        auto promise = std::make_unique<pstd::detail::expected_promise<int, Error>>();
+        auto object = promise->get_return_object();
+        auto moved = std::move(object);
+        promise->return_value(5);
+        promise.reset();
+        const Expected converted = std::move(moved);
+        REQUIRE(*converted == 5);
+    }
+    SECTION("Eager Conversion") {
+        // The return object is converted before the coroutine runs, as MSVC does
+        auto promise = std::make_unique<pstd::detail::expected_promise<int, Error>>();
+        const Expected converted = promise->get_return_object();
+        promise->return_value(pstd::make_unexpected<Error>(Error::Bad));
+        promise.reset();
+        REQUIRE(converted.error() == Error::Bad);
+    }
+}
+
+} // namespace
+
+#endif
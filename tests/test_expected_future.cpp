@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include "expected_future.h"
+
+#include <memory_resource>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#if defined(__cpp_lib_atomic_wait)
+
+namespace {
+
+enum class Error {
+    Broken,
+    Timeout,
+};
+
+using Promise = pstd::promise<std::string, Error>;
+using Future = pstd::future<std::string, Error>;
+
+/// Counts allocations which reach the upstream resource
+class CountingResource : public std::pmr::memory_resource {
+  public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+  private:
+    void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, const std::size_t bytes, const std::size_t alignment) override {
+        deallocations++;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Future", "expected") {
+    SECTION("Value") {
+        Promise promise;
+        Future future = promise.get_future();
+        REQUIRE(future.valid());
+        REQUIRE(!future.is_ready());
+        promise.set_value("value");
+        REQUIRE(future.is_ready());
+        REQUIRE(future.get() == std::string("value"));
+        REQUIRE(!future.valid());
+    }
+    SECTION("Error") {
+        Promise promise;
+        Future future = promise.get_future();
+        promise.set_error(Error::Timeout);
+        REQUIRE(future.get().error() == Error::Timeout);
+    }
+    SECTION("Result") {
+        Promise promise;
+        Future future = promise.get_future();
+        promise.set_result(pstd::make_unexpected<Error>(Error::Timeout));
+        promise.set_value("ignored");
+        REQUIRE(future.get().error() == Error::Timeout);
+    }
+    SECTION("Broken Promise") {
+        Future future;
+        {
+            Promise promise;
+            future = promise.get_future();
+        }
+        REQUIRE(future.broken());
+        REQUIRE_THROWS_AS(future.get(), pstd::detail::broken_promise);
+
+        {
+            Promise promise;
+            future = promise.get_future();
+        }
+        REQUIRE(future.get(Error::Broken).error() == Error::Broken);
+        REQUIRE(!future.valid());
+    }
+    SECTION("Broken Promise With Error Code") {
+        // The default error_code means success, so a broken promise must not look like it
+        pstd::future<int, std::error_code> future;
+        {
+            pstd::promise<int, std::error_code> promise;
+            future = promise.get_future();
+        }
+        REQUIRE(future.broken());
+        const auto result = future.get(std::make_error_code(std::errc::broken_pipe));
+        REQUIRE(result.error() == std::errc::broken_pipe);
+    }
+    SECTION("Kept Promise") {
+        Promise promise;
+        Future future = promise.get_future();
+        promise.set_error(Error::Timeout);
+        REQUIRE(!future.broken());
+        REQUIRE(future.get(Error::Broken).error() == Error::Timeout);
+    }
+    SECTION("Future Destroyed First") {
+        Promise promise;
+        { Future future = promise.get_future(); }
+        promise.set_value("nobody listens");
+    }
+    SECTION("Moved Promise") {
+        Promise promise;
+        Future future = promise.get_future();
+        Promise moved = std::move(promise);
+        moved.set_value("moved");
+        REQUIRE(future.get() == std::string("moved"));
+    }
+    SECTION("Other Thread") {
+        for (int i = 0; i < 100; i++) {
+            Promise promise;
+            Future future = promise.get_future();
+            std::thread thread([p = std::move(promise), i]() mutable { p.set_value(std::to_string(i)); });
+            REQUIRE(future.get() == std::to_string(i));
+            thread.join();
+        }
+    }
+    SECTION("Allocator") {
+        CountingResource upstream;
+        {
+            Promise promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(&upstream));
+            Future future = promise.get_future();
+            promise.set_value("pooled");
+            REQUIRE(upstream.allocations == 1);
+            REQUIRE(future.get() == std::string("pooled"));
+        }
+        REQUIRE(upstream.deallocations == 1);
+    }
+    SECTION("Pool") {
+        CountingResource upstream;
+        std::pmr::unsynchronized_pool_resource pool(&upstream);
+        for (int i = 0; i < 100; i++) {
+            Promise promise(std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>(&pool));
+            Future future = promise.get_future();
+            promise.set_value("pooled");
+            REQUIRE(future.get() == std::string("pooled"));
+        }
+        // States are recycled by the pool
+        REQUIRE(upstream.allocations < 10);
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,151 @@
+#include "catch.hpp"
+
+#include "expected_generator.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+
+enum class Error {
+    Empty,
+    NotNumber,
+};
+
+using Expected = pstd::expected<int, Error>;
+
+int produced = 0;
+
+Expected parse(const std::string &text) {
+    if (text.empty()) {
+        return Error::Empty;
+    }
+    if (text.find_first_not_of("0123456789") != std::string::npos) {
+        return Error::NotNumber;
+    }
+    return std::stoi(text);
+}
+
+pstd::generator<int, Error> parse_all(const std::vector<std::string> lines) {
+    for (const std::string &line : lines) {
+        produced++;
+        co_yield parse(line);
+    }
+}
+
+pstd::generator<int, Error> yield_kinds() {
+    co_yield 1;
+    co_yield pstd::make_unexpected<Error>(Error::Empty);
+    const Expected copied = 3;
+    co_yield copied;
+}
+
+pstd::generator<int, Error> throw_after_one() {
+    co_yield 1;
+    throw std::runtime_error("broken");
+}
+
+pstd::generator<int, Error> count_to(const int count) {
+    for (int i = 0; i < count; i++) {
+        co_yield i;
+    }
+}
+
+const std::vector<std::string> kLines = {"1", "x", "2", "", "3"};
+
+TEST_CASE("Generator", "expected") {
+    SECTION("Lazy") {
+        produced = 0;
+        auto results = parse_all(kLines);
+        REQUIRE(produced == 0);
+        auto it = results.begin();
+        REQUIRE(produced == 1);
+        REQUIRE(*it == 1);
+        ++it;
+        REQUIRE(produced == 2);
+        REQUIRE(it->error() == Error::NotNumber);
+    }
+    SECTION("Results") {
+        std::vector<Expected> results;
+        for (Expected &result : parse_all(kLines)) {
+            results.push_back(std::move(result));
+        }
+        REQUIRE(results == std::vector<Expected>{1, Error::NotNumber, 2, Error::Empty, 3});
+    }
+    SECTION("Yield Kinds") {
+        std::vector<Expected> results;
+        for (const Expected &result : yield_kinds()) {
+            results.push_back(result);
+        }
+        REQUIRE(results == std::vector<Expected>{1, Error::Empty, 3});
+    }
+    SECTION("Exception") {
+        auto results = throw_after_one();
+        auto it = results.begin();
+        REQUIRE(*it == 1);
+        REQUIRE_THROWS_AS(++it, std::runtime_error);
+    }
+    SECTION("Constant Memory") {
+        long long sum = 0;
+        for (const int value : pstd::skip_errors(count_to(1'000'000))) {
+            sum += value;
+        }
+        REQUIRE(sum == 499'999'500'000LL);
+    }
+}
+
+TEST_CASE("ErrorAdaptors", "expected") {
+    SECTION("Until Error") {
+        produced = 0;
+        std::vector<int> values;
+        auto view = pstd::until_error(parse_all(kLines));
+        for (const int value : view) {
+            values.push_back(value);
+        }
+        REQUIRE(values == std::vector<int>{1});
+        REQUIRE(view.error() == Error::NotNumber);
+        REQUIRE(produced == 2);
+    }
+    SECTION("Until Error Without Error") {
+        std::vector<int> values;
+        auto view = pstd::until_error(count_to(3));
+        for (const int value : view) {
+            values.push_back(value);
+        }
+        REQUIRE(values == std::vector<int>{0, 1, 2});
+        REQUIRE(!view.error());
+    }
+    SECTION("Skip Errors") {
+        std::vector<int> values;
+        for (const int value : pstd::skip_errors(parse_all(kLines))) {
+            values.push_back(value);
+        }
+        REQUIRE(values == std::vector<int>{1, 2, 3});
+    }
+    SECTION("Count Errors") {
+        std::vector<int> values;
+        auto view = pstd::skip_errors(parse_all(kLines));
+        for (const int value : view) {
+            values.push_back(value);
+        }
+        REQUIRE(values == std::vector<int>{1, 2, 3});
+        REQUIRE(view.errors() == 2);
+    }
+    SECTION("Other Ranges") {
+        std::vector<Expected> results = {Error::Empty, 4, 5};
+        std::vector<int> values;
+        for (int &value : pstd::skip_errors(results)) {
+            value++;
+            values.push_back(value);
+        }
+        REQUIRE(values == std::vector<int>{5, 6});
+        REQUIRE(*results[1] == 5);
+    }
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,28 @@
+#include "catch.hpp"
+
+#include "expected_instantiations.h"
+
+#include <string>
+#include <system_error>
+
+namespace {
+
+TEST_CASE("ExplicitInstantiations", "expected") {
+    SECTION("Value") {
+        pstd::expected<std::string, std::error_code> e = std::string("value");
+        REQUIRE(e.has_value());
+        REQUIRE(*e == "value");
+        e = std::make_error_code(std::errc::invalid_argument);
+        REQUIRE(!e.has_value());
+        REQUIRE(e.error() == std::errc::invalid_argument);
+    }
+    SECTION("Error") {
+        pstd::expected<int, std::error_code> e = std::make_error_code(std::errc::timed_out);
+        REQUIRE(e.error_or(std::error_code{}) == std::errc::timed_out);
+        REQUIRE(e.value_or(7) == 7);
+        e = 3;
+        REQUIRE(e.value() == 3);
+    }
+}
+
+} // namespace
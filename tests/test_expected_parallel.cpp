@@ -0,0 +1,169 @@
+#include "catch.hpp"
+
+#include "expected_parallel.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    Negative,
+    Odd,
+};
+
+pstd::expected<std::string, Error> describe(const int value) {
+    if (value < 0) {
+        return Error::Negative;
+    }
+    return std::to_string(value);
+}
+
+/// Fails from 101 on, and differently at 900
+pstd::expected<int, Error> check(const int value) {
+    if (value == 900) {
+        return Error::Negative;
+    }
+    if (value > 100 && value % 2 == 1) {
+        return Error::Odd;
+    }
+    return value;
+}
+
+std::vector<int> iota(const int count) {
+    std::vector<int> values(count);
+    std::iota(values.begin(), values.end(), 0);
+    return values;
+}
+
+TEST_CASE("ParallelTransform", "expected") {
+    pstd::thread_pool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    SECTION("Values In Order") {
+        const auto result = pstd::parallel_transform(pool, iota(1000), describe);
+        REQUIRE(result.has_value());
+        REQUIRE(result->size() == 1000);
+        for (int i = 0; i < 1000; i++) {
+            REQUIRE((*result)[i] == std::to_string(i));
+        }
+    }
+    SECTION("Empty") {
+        const auto result = pstd::parallel_transform(pool, std::vector<int>(), describe);
+        REQUIRE(result.has_value());
+        REQUIRE(result->empty());
+    }
+    SECTION("Fewer Elements Than Workers") {
+        const auto result = pstd::parallel_transform(pool, std::vector<int>{5, 6}, describe);
+        REQUIRE(*result == std::vector<std::string>{"5", "6"});
+    }
+    SECTION("Lowest Failing Index") {
+        // Whatever the scheduling, the error is the one of the lowest failing element
+        for (int run = 0; run < 20; run++) {
+            const auto result = pstd::parallel_transform(pool, iota(1000), check);
+            REQUIRE(result.error() == Error::Odd);
+        }
+    }
+    SECTION("Cancellation") {
+        std::atomic<int> calls{0};
+        const auto result = pstd::parallel_transform(pool, iota(100000), [&](const int value) {
+            calls++;
+            return describe((value == 0) ? (-1) : (value));
+        });
+        REQUIRE(result.error() == Error::Negative);
+        REQUIRE(calls < 100000);
+    }
+    SECTION("Reused Pool") {
+        for (int run = 0; run < 100; run++) {
+            const auto result = pstd::parallel_transform(pool, std::vector<int>{run}, describe);
+            REQUIRE((*result)[0] == std::to_string(run));
+        }
+    }
+    SECTION("Shared Pool") {
+        const auto result = pstd::parallel_transform(std::vector<int>{1, 2, 3}, describe);
+        REQUIRE(*result == std::vector<std::string>{"1", "2", "3"});
+    }
+    SECTION("Exception") {
+        auto throwing = [](const int value) -> pstd::expected<int, Error> {
+            if (value == 0 || value == 900) {
+                throw std::runtime_error("thrown");
+            }
+            return value;
+        };
+        for (int run = 0; run < 20; run++) {
+            REQUIRE_THROWS_AS(pstd::parallel_transform(pool, iota(1000), throwing), std::runtime_error);
+        }
+
+        // The pool is still usable
+        const auto result = pstd::parallel_transform(pool, iota(10), check);
+        REQUIRE(result->size() == 10);
+    }
+    SECTION("Nested") {
+        const auto result = pstd::parallel_transform(pool, iota(8), [&](const int value) {
+            const auto inner = pstd::parallel_transform(pool, iota(value), check);
+            return pstd::expected<int, Error>(static_cast<int>(inner->size()));
+        });
+        REQUIRE(*result == iota(8));
+
+        const auto shared = pstd::parallel_transform(iota(4), [](const int value) {
+            std::vector<pstd::expected<int, Error>> results(static_cast<std::size_t>(value), 1);
+            return pstd::expected<int, Error>(static_cast<int>(pstd::partition_results(results).values.size()));
+        });
+        REQUIRE(*shared == iota(4));
+    }
+}
+
+TEST_CASE("PartitionResults", "expected") {
+    pstd::thread_pool pool(4);
+
+    SECTION("In Order") {
+        std::vector<pstd::expected<int, Error>> results;
+        for (const int value : iota(1000)) {
+            results.push_back(check(value));
+        }
+        const auto [values, errors] = pstd::partition_results(pool, results);
+        REQUIRE(values.size() == 549);
+        REQUIRE(errors.size() == 451);
+        REQUIRE(values[100] == 100);
+        REQUIRE(values[101] == 102);
+        REQUIRE(values.back() == 998);
+        REQUIRE(errors.front() == Error::Odd);
+        REQUIRE(errors[(900 - 101) / 2 + 1] == Error::Negative);
+    }
+    SECTION("Moves") {
+        std::vector<pstd::expected<std::string, Error>> results;
+        for (const int value : {1, -1, 2, 3, -4}) {
+            results.push_back(describe(value));
+        }
+        const auto copied = pstd::partition_results(pool, results);
+        REQUIRE(copied.values == std::vector<std::string>{"1", "2", "3"});
+        REQUIRE(*results[0] == "1");
+
+        const auto moved = pstd::partition_results(pool, std::move(results));
+        REQUIRE(moved.values == std::vector<std::string>{"1", "2", "3"});
+        REQUIRE(moved.errors.size() == 2);
+        REQUIRE(results[0]->empty());
+    }
+    SECTION("Fewer Elements Than Workers") {
+        for (const int count : {0, 1, 3}) {
+            std::vector<pstd::expected<std::string, Error>> results;
+            for (const int value : iota(count)) {
+                results.push_back(describe(value));
+            }
+            const auto partitioned = pstd::partition_results(pool, results);
+            REQUIRE(partitioned.values.size() == static_cast<std::size_t>(count));
+            REQUIRE(partitioned.errors.empty());
+        }
+    }
+    SECTION("Shared Pool") {
+        const std::vector<pstd::expected<std::string, Error>> results = {describe(-1), describe(7)};
+        const auto partitioned = pstd::partition_results(results);
+        REQUIRE(partitioned.values == std::vector<std::string>{"7"});
+        REQUIRE(partitioned.errors == std::vector<Error>{Error::Negative});
+    }
+}
+
+} // namespace
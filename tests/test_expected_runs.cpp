@@ -0,0 +1,76 @@
+#include "catch.hpp"
+
+#include "expected_runs.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    None,
+    Bad,
+};
+
+using Vector = pstd::expected_vector<int, Error>;
+
+std::vector<std::size_t> errors_of(const pstd::state_runs &runs) {
+    std::vector<std::size_t> errors;
+    runs.for_each_error([&](const std::size_t index) { errors.push_back(index); });
+    return errors;
+}
+
+TEST_CASE("StateRuns", "expected") {
+    SECTION("Push") {
+        pstd::state_runs runs;
+        REQUIRE(runs.empty());
+        for (const bool has_value : {true, false, false, true, true, false}) {
+            runs.push_back(has_value);
+        }
+        REQUIRE(runs.size() == 6);
+        REQUIRE(runs.runs().size() == 2);
+        REQUIRE(runs.runs()[0].begin == 1);
+        REQUIRE(runs.runs()[0].length == 2);
+        REQUIRE(runs.count_errors() == 3);
+        REQUIRE(runs.count_values() == 3);
+        REQUIRE(errors_of(runs) == std::vector<std::size_t>{1, 2, 5});
+        REQUIRE(runs.has_value(0));
+        REQUIRE(!runs.has_value(2));
+        REQUIRE(runs.has_value(3));
+        REQUIRE(!runs.has_value(5));
+    }
+    SECTION("From bitmap") {
+        // Runs inside a word, at its ends, across words and filling a whole word
+        Vector vector;
+        pstd::state_runs expected;
+        for (std::size_t i = 0; i < 300; i++) {
+            const bool has_value = !(i == 0 || (i >= 10 && i < 12) || (i >= 60 && i < 70) || (i >= 128 && i < 192) ||
+                                     i == 255 || i == 299);
+            if (has_value) {
+                vector.push_back(static_cast<int>(i));
+            } else {
+                vector.push_back(pstd::make_unexpected<Error>(Error::Bad));
+            }
+            expected.push_back(has_value);
+        }
+        const pstd::state_runs runs = pstd::state_runs::from_vector(vector);
+        REQUIRE(runs.size() == 300);
+        REQUIRE(runs.runs().size() == 6);
+        REQUIRE(runs.runs()[2].begin == 60);
+        REQUIRE(runs.runs()[2].length == 10);
+        REQUIRE(runs.runs()[3].length == 64);
+        REQUIRE(errors_of(runs) == errors_of(expected));
+        REQUIRE(runs.count_errors() == vector.count_errors());
+        for (std::size_t i = 0; i < vector.size(); i++) {
+            REQUIRE(runs.has_value(i) == vector.has_value(i));
+        }
+    }
+    SECTION("Without errors") {
+        const Vector vector = {1, 2, 3};
+        const pstd::state_runs runs = pstd::state_runs::from_vector(vector);
+        REQUIRE(runs.runs().empty());
+        REQUIRE(runs.count_values() == 3);
+    }
+}
+
+} // namespace
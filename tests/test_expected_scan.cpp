@@ -0,0 +1,146 @@
+#include "catch.hpp"
+
+#include "expected_scan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__cpp_lib_span)
+
+namespace {
+
+enum class Error : char {
+    Bad = 1,
+};
+
+struct Triple {
+    double a = 0;
+    double b = 0;
+    double c = 0;
+
+    bool operator==(const Triple &other) const { return a == other.a && b == other.b && c == other.c; }
+};
+
+template <typename V>
+V make_value(const std::size_t i) {
+    if constexpr (std::is_same_v<V, Triple>) {
+        return Triple{static_cast<double>(i), 1.0, 2.0};
+    } else if constexpr (std::is_same_v<V, std::string>) {
+        return std::to_string(i);
+    } else {
+        return static_cast<V>(i);
+    }
+}
+
+template <typename V>
+std::vector<pstd::expected<V, Error>> make_results(const std::size_t count, const double error_rate,
+                                                   const unsigned seed) {
+    std::mt19937 generator(seed);
+    std::bernoulli_distribution is_error(error_rate);
+    std::vector<pstd::expected<V, Error>> results;
+    for (std::size_t i = 0; i < count; i++) {
+        if (is_error(generator)) {
+            results.push_back(pstd::make_unexpected<Error>(Error::Bad));
+        } else {
+            results.push_back(make_value<V>(i));
+        }
+    }
+    return results;
+}
+
+/// Every kernel against [std::count_if], [std::find_if] and [std::copy_if]
+template <typename V>
+void check_kernels() {
+    using Expected = pstd::expected<V, Error>;
+    const auto has_error = [](const Expected &result) { return !result.has_value(); };
+    const std::vector<pstd::scan::instruction_set> sets = {
+        pstd::scan::instruction_set::scalar,
+        pstd::scan::instruction_set::sse42,
+        pstd::scan::instruction_set::avx2,
+    };
+    for (const auto set : sets) {
+        if (!pstd::scan::is_supported(set)) {
+            continue;
+        }
+        for (const std::size_t count : {0, 1, 3, 31, 32, 33, 100, 2500}) {
+            for (const double error_rate : {0.0, 0.01, 0.5, 1.0}) {
+                const auto results = make_results<V>(count, error_rate, static_cast<unsigned>(count));
+                const std::span<const Expected> span(results);
+
+                const auto errors = static_cast<std::size_t>(std::count_if(results.begin(), results.end(), has_error));
+                REQUIRE(pstd::scan::count_errors(span, set) == errors);
+
+                const auto first = static_cast<std::size_t>(
+                    std::find_if(results.begin(), results.end(), has_error) - results.begin());
+                REQUIRE(pstd::scan::find_first_error(span, set) == first);
+
+                std::vector<V> expected_values;
+                for (const auto &result : results) {
+                    if (result) {
+                        expected_values.push_back(*result);
+                    }
+                }
+                std::vector<V> values(count);
+                const std::size_t written = pstd::scan::gather_values(span, std::span<V>(values), set);
+                values.resize(written);
+                REQUIRE(values == expected_values);
+            }
+        }
+    }
+}
+
+TEST_CASE("Scan", "expected") {
+    SECTION("State Offset") {
+        const pstd::expected<double, Error> value = 1.0;
+        const pstd::expected<double, Error> error = pstd::make_unexpected<Error>(Error::Bad);
+        unsigned char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        REQUIRE(bytes[pstd::detail::state_offset_v<double, Error>] == 1);
+        std::memcpy(bytes, &error, sizeof(error));
+        REQUIRE(bytes[pstd::detail::state_offset_v<double, Error>] == 0);
+    }
+    SECTION("Stride 2") {
+        STATIC_REQUIRE(sizeof(pstd::expected<char, Error>) == 2);
+        check_kernels<char>();
+    }
+    SECTION("Stride 8") {
+        STATIC_REQUIRE(sizeof(pstd::expected<int, Error>) == 8);
+        check_kernels<int>();
+    }
+    SECTION("Stride 16") {
+        STATIC_REQUIRE(sizeof(pstd::expected<double, Error>) == 16);
+        check_kernels<double>();
+    }
+    SECTION("Stride 32") {
+        STATIC_REQUIRE(sizeof(pstd::expected<Triple, Error>) == 32);
+        check_kernels<Triple>();
+    }
+    SECTION("Scalar Stride") {
+        check_kernels<std::string>();
+    }
+    SECTION("Output Too Small") {
+        using Expected = pstd::expected<int, Error>;
+        const auto results = make_results<int>(600, 0.0, 1);
+        std::vector<int> values(300, -1);
+        REQUIRE_THROWS_AS(pstd::scan::gather_values(std::span<const Expected>(results), std::span<int>(values)),
+                          std::length_error);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            REQUIRE(values[i] == static_cast<int>(i));
+        }
+
+        // Only the values need to fit
+        const auto mixed = make_results<int>(600, 0.5, 2);
+        const auto count = static_cast<std::size_t>(std::count_if(mixed.begin(), mixed.end(),
+                                                                   [](const Expected &result) { return result.has_value(); }));
+        std::vector<int> fitted(count);
+        REQUIRE(pstd::scan::gather_values(std::span<const Expected>(mixed), std::span<int>(fitted)) == count);
+    }
+}
+
+} // namespace
+
+#endif
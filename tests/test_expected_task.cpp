@@ -0,0 +1,216 @@
+#include "catch.hpp"
+
+#include "expected_task.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+
+namespace {
+
+enum class Error {
+    Bad,
+    Terrible,
+};
+
+template <typename T>
+using Task = pstd::task<T, Error>;
+
+int started = 0;
+
+Task<int> succeed(const int value) {
+    started++;
+    co_return value;
+}
+
+Task<int> fail(const Error error) {
+    started++;
+    co_return pstd::make_unexpected<Error>(error);
+}
+
+Task<int> add(Task<int> a, Task<int> b) {
+    const int x = co_await co_await std::move(a);
+    const int y = co_await co_await std::move(b);
+    co_return x + y;
+}
+
+Task<std::string> describe(Task<int> work) {
+    const int value = co_await co_await std::move(work);
+    co_return std::to_string(value);
+}
+
+Task<int> forward(Task<int> work) {
+    co_return co_await std::move(work);
+}
+
+Task<int> chain(const int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    co_return co_await co_await chain(depth - 1) + 1;
+}
+
+/// Resumes the awaiting coroutine on a new thread
+struct resume_on_new_thread {
+    std::thread &thread_;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(const std::coroutine_handle<> handle) {
+        thread_ = std::thread([handle] { handle.resume(); });
+    }
+
+    std::thread::id await_resume() const noexcept { return std::this_thread::get_id(); }
+};
+
+Task<std::thread::id> switch_thread(std::thread &thread) {
+    co_return co_await resume_on_new_thread{thread};
+}
+
+/// Suspends the awaiting coroutine until [resume_parked] resumes it
+struct parked {
+    static inline std::mutex mutex;
+    static inline std::vector<std::coroutine_handle<>> handles;
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(const std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handles.push_back(handle);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+Task<int> park(const int value) {
+    co_await parked{};
+    co_return value;
+}
+
+/// Waits for [count] coroutines to park, then resumes all of those which did, returns how many did
+std::size_t resume_parked(const std::size_t count) {
+    std::vector<std::coroutine_handle<>> handles;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::lock_guard<std::mutex> lock(parked::mutex);
+        if (parked::handles.size() >= count) {
+            break;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(parked::mutex);
+        handles.swap(parked::handles);
+    }
+    for (const auto handle : handles) {
+        handle.resume();
+    }
+    return handles.size();
+}
+
+TEST_CASE("Task", "expected") {
+    SECTION("Lazy") {
+        started = 0;
+        auto work = succeed(1);
+        REQUIRE(started == 0);
+        REQUIRE(pstd::sync_wait(std::move(work)) == 1);
+        REQUIRE(started == 1);
+    }
+    SECTION("Destroyed Without Starting") {
+        started = 0;
+        { auto work = succeed(1); }
+        REQUIRE(started == 0);
+    }
+    SECTION("Chain") {
+        REQUIRE(pstd::sync_wait(add(succeed(2), succeed(3))) == 5);
+        REQUIRE(pstd::sync_wait(describe(succeed(7))) == std::string("7"));
+        REQUIRE(pstd::sync_wait(forward(succeed(7))) == 7);
+    }
+    SECTION("Error Propagation") {
+        started = 0;
+        const auto result = pstd::sync_wait(add(fail(Error::Bad), succeed(3)));
+        REQUIRE(!result.has_value());
+        REQUIRE(result.error() == Error::Bad);
+        REQUIRE(started == 1);
+
+        const auto described = pstd::sync_wait(describe(fail(Error::Terrible)));
+        REQUIRE(described.error() == Error::Terrible);
+
+        const auto forwarded = pstd::sync_wait(forward(fail(Error::Terrible)));
+        REQUIRE(forwarded.error() == Error::Terrible);
+    }
+    SECTION("Deep Chain") {
+        // The trampoline keeps the stack flat however deep the chain, at any optimization level
+        REQUIRE(pstd::sync_wait(chain(1000000)) == 1000000);
+    }
+    SECTION("Other Thread") {
+        std::thread thread;
+        const auto id = pstd::sync_wait(switch_thread(thread));
+        thread.join();
+        REQUIRE(id.has_value());
+        REQUIRE(*id != std::this_thread::get_id());
+    }
+}
+
+TEST_CASE("WhenAll", "expected") {
+    SECTION("Values") {
+        const auto values = pstd::sync_wait(pstd::when_all(succeed(1), describe(succeed(2)), succeed(3)));
+        REQUIRE(values.has_value());
+        REQUIRE(std::get<0>(*values) == 1);
+        REQUIRE(std::get<1>(*values) == std::string("2"));
+        REQUIRE(std::get<2>(*values) == 3);
+    }
+    SECTION("First Error") {
+        started = 0;
+        const auto values = pstd::sync_wait(pstd::when_all(succeed(1), fail(Error::Bad), fail(Error::Terrible)));
+        REQUIRE(!values.has_value());
+        REQUIRE(values.error() == Error::Bad);
+        REQUIRE(started == 2);
+    }
+    SECTION("Concurrent") {
+        // Both tasks park before either is resumed, which needs them to be started together
+        std::size_t resumed = 0;
+        std::thread resumer([&] { resumed = resume_parked(2); });
+        const auto values = pstd::sync_wait(pstd::when_all(park(1), park(2)));
+        resumer.join();
+        REQUIRE(resumed == 2);
+        REQUIRE(std::get<0>(*values) == 1);
+        REQUIRE(std::get<1>(*values) == 2);
+
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 3; i++) {
+            tasks.push_back(park(i));
+        }
+        tasks.push_back(fail(Error::Bad));
+        std::thread vector_resumer([&] { resumed = resume_parked(3); });
+        const auto failed = pstd::sync_wait(pstd::when_all(std::move(tasks)));
+        vector_resumer.join();
+        REQUIRE(resumed == 3);
+        REQUIRE(failed.error() == Error::Bad);
+    }
+    SECTION("Vector") {
+        std::vector<Task<int>> tasks;
+        for (int i = 0; i < 4; i++) {
+            tasks.push_back(succeed(i));
+        }
+        const auto values = pstd::sync_wait(pstd::when_all(std::move(tasks)));
+        REQUIRE(values.has_value());
+        REQUIRE(*values == std::vector<int>{0, 1, 2, 3});
+
+        started = 0;
+        tasks.clear();
+        tasks.push_back(succeed(0));
+        tasks.push_back(fail(Error::Terrible));
+        tasks.push_back(succeed(2));
+        const auto failed = pstd::sync_wait(pstd::when_all(std::move(tasks)));
+        REQUIRE(failed.error() == Error::Terrible);
+        REQUIRE(started == 2);
+    }
+}
+
+} // namespace
+
+#endif
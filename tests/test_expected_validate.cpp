@@ -0,0 +1,126 @@
+#include "catch.hpp"
+
+#include "expected_validate.h"
+
+#include <memory_resource>
+#include <string>
+
+namespace {
+
+enum class Error {
+    EmptyName,
+    BadAge,
+    BadEmail,
+};
+
+pstd::expected<std::string, Error> check_name(const std::string &name) {
+    if (name.empty()) {
+        return Error::EmptyName;
+    }
+    return name;
+}
+
+pstd::expected<int, Error> check_age(const int age) {
+    if (age < 0 || age > 150) {
+        return Error::BadAge;
+    }
+    return age;
+}
+
+pstd::expected<std::string, Error> check_email(const std::string &email) {
+    if (email.find('@') == std::string::npos) {
+        return Error::BadEmail;
+    }
+    return email;
+}
+
+/// Counts allocations which reach the upstream resource
+class CountingResource : public std::pmr::memory_resource {
+  public:
+    std::size_t allocations = 0;
+
+  private:
+    void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, const std::size_t bytes, const std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Validate", "expected") {
+    SECTION("Values") {
+        const auto request = pstd::validate(check_name("ada"), check_age(36), check_email("ada@example.com"));
+        REQUIRE(request.has_value());
+        const auto &[name, age, email] = *request;
+        REQUIRE(name == "ada");
+        REQUIRE(age == 36);
+        REQUIRE(email == "ada@example.com");
+    }
+    SECTION("Every Error") {
+        const auto request = pstd::validate(check_name(""), check_age(36), check_email("nobody"));
+        REQUIRE(!request.has_value());
+        const auto &errors = request.error();
+        REQUIRE(errors.size() == 2);
+        REQUIRE(errors[0] == Error::EmptyName);
+        REQUIRE(errors[1] == Error::BadEmail);
+        REQUIRE(errors.is_inline());
+    }
+    SECTION("Lvalues") {
+        const auto name = check_name("ada");
+        auto age = check_age(200);
+        const auto request = pstd::validate(name, age);
+        REQUIRE(request.error().size() == 1);
+        REQUIRE(request.error()[0] == Error::BadAge);
+    }
+}
+
+TEST_CASE("Validator", "expected") {
+    SECTION("Passes") {
+        pstd::validator<Error, 2> validator;
+        REQUIRE(validator.check(check_age(1)));
+        REQUIRE(validator.check(check_name("ada")));
+        REQUIRE(validator);
+        REQUIRE(validator.errors().empty());
+    }
+    SECTION("Inline") {
+        pstd::validator<Error, 2> validator;
+        REQUIRE(!validator.check(check_age(-1)));
+        REQUIRE(!validator.check(check_email("")));
+        REQUIRE(!validator);
+        REQUIRE(validator.errors().is_inline());
+        const auto errors = std::move(validator).errors();
+        REQUIRE(std::vector<Error>(errors.begin(), errors.end()) == std::vector<Error>{Error::BadAge, Error::BadEmail});
+    }
+    SECTION("Overflow") {
+        pstd::validator<Error, 2> validator;
+        for (int age = 200; age < 210; age++) {
+            validator.check(check_age(age));
+        }
+        validator.check(check_name(""));
+        const auto &errors = validator.errors();
+        REQUIRE(!errors.is_inline());
+        REQUIRE(errors.size() == 11);
+        REQUIRE(errors[0] == Error::BadAge);
+        REQUIRE(errors[10] == Error::EmptyName);
+    }
+    SECTION("Arena") {
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        pstd::validator<Error, 2, std::pmr::polymorphic_allocator<Error>> validator(&arena);
+        validator.check(check_age(-1));
+        validator.check(check_age(-2));
+        REQUIRE(upstream.allocations == 0);
+        validator.check(check_age(-3));
+        REQUIRE(validator.errors().size() == 3);
+        REQUIRE(upstream.allocations == 1);
+    }
+}
+
+} // namespace
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+
+#include "expected_vector.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class Error {
+    None,
+    Bad,
+    Worse,
+};
+
+using Expected = pstd::expected<double, Error>;
+using Vector = pstd::expected_vector<double, Error>;
+
+#if defined(__cpp_lib_concepts)
+static_assert(std::random_access_iterator<Vector::iterator>);
+static_assert(std::random_access_iterator<Vector::const_iterator>);
+#endif
+
+/// Throws when constructed from a negative number
+struct Checked {
+    int value = 0;
+
+    Checked() = default;
+
+    explicit Checked(const int v) : value(v) {
+        if (v < 0) {
+            throw std::invalid_argument("negative");
+        }
+    }
+};
+
+TEST_CASE("ExpectedVector", "expected") {
+    SECTION("Push") {
+        Vector vector;
+        REQUIRE(vector.empty());
+        vector.push_back(1.0);
+        vector.push_back(pstd::make_unexpected<Error>(Error::Bad));
+        vector.emplace_value(3.0);
+        vector.emplace_error(Error::Worse);
+        REQUIRE(vector.size() == 4);
+        REQUIRE(vector[0] == Expected(1.0));
+        REQUIRE(vector[1].error() == Error::Bad);
+        REQUIRE(*vector[2] == 3.0);
+        REQUIRE(!vector[3]);
+        REQUIRE(vector.count_values() == 2);
+        REQUIRE(vector.count_errors() == 2);
+    }
+    SECTION("Layout") {
+        Vector vector = {1.0, Error::Bad, 3.0};
+        REQUIRE(vector.bitmap()[0] == 0b101);
+        REQUIRE(vector.values()[1] == 0.0);
+        REQUIRE(vector.values()[2] == 3.0);
+        REQUIRE(vector.errors()[1] == Error::Bad);
+        REQUIRE(vector.errors()[0] == Error::None);
+    }
+    SECTION("Reference") {
+        Vector vector = {1.0, Error::Bad};
+        REQUIRE(vector[0].value() == 1.0);
+        REQUIRE_THROWS(vector[1].value());
+        REQUIRE(vector[1].value_or(5.0) == 5.0);
+
+        vector[0] = pstd::make_unexpected<Error>(Error::Worse);
+        vector[1] = 2.0;
+        REQUIRE(vector[0].error() == Error::Worse);
+        REQUIRE(vector[1] == Expected(2.0));
+        REQUIRE(vector.bitmap()[0] == 0b10);
+
+        *vector[1] += 1.0;
+        REQUIRE(*vector[1] == 3.0);
+
+        vector[0] = vector[1];
+        REQUIRE(vector[0] == Expected(3.0));
+
+        const Expected copy = vector[0];
+        REQUIRE(copy == 3.0);
+    }
+    SECTION("Iteration") {
+        const Vector vector = {1.0, Error::Bad, 3.0};
+        std::vector<Expected> copies;
+        for (const auto element : vector) {
+            copies.push_back(element);
+        }
+        REQUIRE(copies == std::vector<Expected>{1.0, Error::Bad, 3.0});
+        REQUIRE(vector.end() - vector.begin() == 3);
+    }
+    SECTION("Random Access") {
+        const Vector vector = {1.0, 2.0, Error::Bad, 4.0};
+        const auto first = vector.begin();
+        const auto third = 2 + first;
+        REQUIRE(third == first + 2);
+        REQUIRE(third > first);
+        REQUIRE(third >= first);
+        REQUIRE(first <= third);
+        REQUIRE(!(first > third));
+        REQUIRE(third[1] == Expected(4.0));
+        REQUIRE(std::distance(vector.begin(), vector.end()) == 4);
+        const auto found = std::find_if(vector.begin(), vector.end(), [](const auto element) { return !element; });
+        REQUIRE(found == third);
+    }
+    SECTION("Throwing Constructor") {
+        pstd::expected_vector<Checked, Error> vector;
+        for (int i = 0; i < 64; i++) {
+            vector.emplace_value(i);
+        }
+        REQUIRE_THROWS_AS(vector.emplace_value(-1), std::invalid_argument);
+        REQUIRE(vector.size() == 64);
+        vector.emplace_error(Error::Bad);
+        REQUIRE(vector.size() == 65);
+        REQUIRE(vector.count_errors() == 1);
+        REQUIRE(vector[64].error() == Error::Bad);
+        REQUIRE(vector[63]->value == 63);
+    }
+    SECTION("Values And Errors") {
+        Vector vector;
+        for (int i = 0; i < 200; i++) {
+            if (i % 3 == 0 && i < 150) {
+                vector.push_back(pstd::make_unexpected<Error>(Error::Bad));
+            } else {
+                vector.push_back(static_cast<double>(i));
+            }
+        }
+        std::vector<std::size_t> values;
+        vector.for_each_value([&](const std::size_t index, const double value) {
+            REQUIRE(value == static_cast<double>(index));
+            values.push_back(index);
+        });
+        std::vector<std::size_t> errors;
+        vector.for_each_error([&](const std::size_t index, Error &error) {
+            REQUIRE(error == Error::Bad);
+            errors.push_back(index);
+        });
+        REQUIRE(values.size() + errors.size() == 200);
+        REQUIRE(errors.size() == vector.count_errors());
+        REQUIRE(errors.front() == 0);
+        REQUIRE(errors.back() == 147);
+        REQUIRE(values.back() == 199);
+    }
+    SECTION("Non Trivial") {
+        pstd::expected_vector<std::string, std::string> vector;
+        vector.push_back(std::string("value"));
+        vector.push_back(pstd::make_unexpected<std::string>("error"));
+        REQUIRE(vector[0]->size() == 5);
+        REQUIRE(vector[1].error() == "error");
+    }
+}
+
+} // namespace